@@ -0,0 +1,172 @@
+// MemArchive.cpp
+// in process 7z archiving of a memory buffer, for cherrytree
+
+#include "StdAfx.h"
+
+#include "../../../Common/MyCom.h"
+#include "../../../Common/MyException.h"
+#include "../../../Common/StringConvert.h"
+
+#include "../../../Windows/PropVariant.h"
+#include "../../../Windows/TimeUtils.h"
+
+#include "../../Common/FileStreams.h"
+#include "../../Common/StreamObjects.h"
+
+#include "../../Archive/7z/7zHandler.h"
+
+#include "../../IPassword.h"
+
+#include "ExitCode.h"
+
+#include "myPrivate.h"
+
+#ifdef ENV_HAVE_LOCALE
+#include <locale.h>
+#endif
+
+#include <string.h>
+#include <strings.h>
+
+using namespace NWindows;
+
+// same detection of the strings conversion as the command line (mySplitCommandLine)
+// so that the password and the paths are converted exactly like by p7za_exec
+static void InitStringsConversion()
+{
+#ifdef ENV_HAVE_LOCALE
+  const char *locale = setlocale(LC_CTYPE, 0);
+  global_use_utf16_conversion = 0;
+  if (locale
+      && strcmp(locale, "") != 0
+      && strcasecmp(locale, "C") != 0
+      && strcasecmp(locale, "POSIX") != 0)
+    global_use_utf16_conversion = 1;
+#elif defined(LOCALE_IS_UTF8)
+  global_use_utf16_conversion = 1;
+#else
+  global_use_utf16_conversion = 0;
+#endif
+}
+
+class CMemUpdateCallback:
+  public IArchiveUpdateCallback2,
+  public ICryptoGetTextPassword2,
+  public CMyUnknownImp
+{
+public:
+  MY_UNKNOWN_IMP2(IArchiveUpdateCallback2, ICryptoGetTextPassword2)
+
+  INTERFACE_IArchiveUpdateCallback2(;)
+
+  STDMETHOD(CryptoGetTextPassword2)(Int32 *passwordIsDefined, BSTR *password);
+
+  const Byte *Data;
+  size_t Size;
+  UString ItemName;
+  UString Password;
+  FILETIME MTime;
+};
+
+STDMETHODIMP CMemUpdateCallback::SetTotal(UInt64 /* size */) { return S_OK; }
+STDMETHODIMP CMemUpdateCallback::SetCompleted(const UInt64 * /* completeValue */) { return S_OK; }
+
+STDMETHODIMP CMemUpdateCallback::GetUpdateItemInfo(UInt32 /* index */,
+      Int32 *newData, Int32 *newProperties, UInt32 *indexInArchive)
+{
+  if (newData)
+    *newData = BoolToInt(true);
+  if (newProperties)
+    *newProperties = BoolToInt(true);
+  if (indexInArchive)
+    *indexInArchive = (UInt32)(Int32)-1;
+  return S_OK;
+}
+
+STDMETHODIMP CMemUpdateCallback::GetProperty(UInt32 /* index */, PROPID propID, PROPVARIANT *value)
+{
+  NCOM::CPropVariant prop;
+  switch (propID)
+  {
+    case kpidPath: prop = ItemName; break;
+    case kpidIsDir: prop = false; break;
+    case kpidIsAnti: prop = false; break;
+    case kpidSize: prop = (UInt64)Size; break;
+    case kpidAttrib: prop = (UInt32)FILE_ATTRIBUTE_ARCHIVE; break;
+    case kpidMTime: prop = MTime; break;
+  }
+  prop.Detach(value);
+  return S_OK;
+}
+
+STDMETHODIMP CMemUpdateCallback::GetStream(UInt32 /* index */, ISequentialInStream **inStream)
+{
+  CBufInStream *inStreamSpec = new CBufInStream;
+  CMyComPtr<ISequentialInStream> inStreamLoc = inStreamSpec;
+  inStreamSpec->Init(Data, Size);
+  *inStream = inStreamLoc.Detach();
+  return S_OK;
+}
+
+STDMETHODIMP CMemUpdateCallback::SetOperationResult(Int32 /* operationResult */) { return S_OK; }
+
+STDMETHODIMP CMemUpdateCallback::GetVolumeSize(UInt32 /* index */, UInt64 * /* size */) { return S_FALSE; }
+STDMETHODIMP CMemUpdateCallback::GetVolumeStream(UInt32 /* index */, ISequentialOutStream ** /* volumeStream */) { return S_FALSE; }
+
+STDMETHODIMP CMemUpdateCallback::CryptoGetTextPassword2(Int32 *passwordIsDefined, BSTR *password)
+{
+  *passwordIsDefined = BoolToInt(!Password.IsEmpty());
+  return StringToBstr(Password, password);
+}
+
+static HRESULT MemArchive(const Byte *data, size_t size, const char *itemName, const char *outputPath,
+    const char *passwd, UInt32 numThreads)
+{
+  CMemUpdateCallback *updateCallbackSpec = new CMemUpdateCallback;
+  CMyComPtr<IArchiveUpdateCallback2> updateCallback = updateCallbackSpec;
+  updateCallbackSpec->Data = data;
+  updateCallbackSpec->Size = size;
+  updateCallbackSpec->ItemName = MultiByteToUnicodeString(AString(itemName));
+  updateCallbackSpec->Password = MultiByteToUnicodeString(AString(passwd));
+  NTime::GetCurUtcFileTime(updateCallbackSpec->MTime);
+
+  NArchive::N7z::CHandler *handlerSpec = new NArchive::N7z::CHandler;
+  CMyComPtr<IOutArchive> outArchive = handlerSpec;
+
+  // as by the command line -m0=LZMA2:d64k:fb32 -ms=8m -mmt=N -mx=1
+  const wchar_t *names[] = { L"x", L"0", L"s", L"mt" };
+  NCOM::CPropVariant values[4];
+  values[0] = (UInt32)1;
+  values[1] = L"LZMA2:d64k:fb32";
+  values[2] = L"8m";
+  values[3] = numThreads;
+  RINOK(handlerSpec->SetProperties(names, values, 4));
+
+  COutFileStream *outStreamSpec = new COutFileStream;
+  CMyComPtr<IOutStream> outStream = outStreamSpec;
+  if (!outStreamSpec->Create(us2fs(MultiByteToUnicodeString(AString(outputPath))), true))
+    return E_FAIL;
+
+  RINOK(outArchive->UpdateItems(outStream, 1, updateCallback));
+  return outStreamSpec->Close();
+}
+
+int p7za_archive_mem(const void *data, size_t size, const char *itemName, const char *outputPath,
+    const char *passwd, unsigned numThreads)
+{
+  InitStringsConversion();
+  try
+  {
+    if (MemArchive((const Byte *)data, size, itemName, outputPath, passwd, (UInt32)numThreads) != S_OK)
+      return NExitCode::kFatalError;
+  }
+  catch(const CNewException &)
+  {
+    return NExitCode::kMemoryError;
+  }
+  catch(...)
+  {
+    return NExitCode::kFatalError;
+  }
+  return NExitCode::kSuccess;
+}
@@ -78,6 +78,31 @@ private:
 private:
     CtSearchOptions _s_options;
     CtSearchState _s_state;
+    // text and anchors of the buffer being searched, kept across the search steps until the buffer changes
+    struct CtSearchBufferCache
+    {
+        ~CtSearchBufferCache() { bufferChangedConn.disconnect(); }
+        Glib::RefPtr<Gtk::TextBuffer> rBuffer;
+        sigc::connection              bufferChangedConn;
+        bool                          textValid{false};
+        bool                          textFolded{false};  // diacritical to ascii
+        CtUtf8Cursor                  textCursor;         // buffer text, anchors excluded
+        bool                          anchorsValid{false};
+        std::vector<int>              anchorsTextOffsets; // sorted offsets of the anchors, minus the anchors before
+    };
+    CtSearchBufferCache _s_buffer_cache;
+    std::optional<CtLiteralFinder> _s_literal_finder; // set for a not regular expression search
+    std::map<std::pair<std::string, int>, Glib::RefPtr<Glib::Regex>> _s_re_cache;
+    // what the match of the nodes stored content needs, copied by value for the worker threads
+    struct CtContentMatcher
+    {
+        Glib::RefPtr<Glib::Regex>      re_pattern;
+        std::optional<CtLiteralFinder> literal_finder;
+        bool                           accent_insensitive{false};
+        bool                           objects_too{true}; // not a replace
+    };
+    class CtContentPrefetcher;
+    CtContentPrefetcher* _s_pContentPrefetcher{nullptr}; // set during a multiple nodes find all
 
 public:
     CtMainWin*   getCtMainWin() { return _pCtMainWin; }
@@ -192,6 +217,7 @@ public:
     void node_siblings_sort_descending();
     void node_go_back();    // was as go_back
     void node_go_forward(); // was as go_forward
+    void node_quick_jump();
 
     void bookmark_curr_node();
     void bookmark_curr_node_remove();
@@ -219,6 +245,10 @@ private:
                                         const bool forward,
                                         const bool all_matches);
     bool _is_node_within_time_filter(const CtTreeIter& node_iter);
+    bool _is_node_content_search_eligible(const CtTreeIter& node_iter);
+    bool _is_node_content_candidate(const CtTreeIter& node_iter, Glib::RefPtr<Glib::Regex> re_pattern);
+    CtContentMatcher _get_content_matcher(Glib::RefPtr<Glib::Regex> re_pattern) const;
+    static bool _raw_text_has_match(CtStorageNodeRawText& raw_text, const CtContentMatcher& matcher);
     Glib::RefPtr<Glib::Regex> _create_re_pattern(Glib::ustring pattern);
     bool _find_pattern(CtTreeIter tree_iter,
                        Glib::RefPtr<Gtk::TextBuffer> text_buffer,
@@ -240,7 +270,11 @@ private:
                                                          bool forward,
                                                          Glib::ustring& obj_content);
     int  _get_num_objs_before_offset(Glib::RefPtr<Gtk::TextBuffer> text_buffer, int max_offset);
+    bool _anchors_offsets_shift(const int start_offset, const int end_offset, const int delta);
+    void _search_buffer_cache_set(Glib::RefPtr<Gtk::TextBuffer> text_buffer);
     void _update_all_matches_progress();
+    void _check_max_matches();
+    void _replace_all_finalise_nodes();
 public:
     void find_matches_store_reset();
 
@@ -182,6 +182,7 @@ void CtActions::preferences_import()
     _pCtConfig->showNodeNameHeader = ctConfigImported.showNodeNameHeader;
     _pCtConfig->nodesOnNodeNameHeader = ctConfigImported.nodesOnNodeNameHeader;
     _pCtConfig->maxMatchesInPage = ctConfigImported.maxMatchesInPage;
+    _pCtConfig->maxMatchesInSearch = ctConfigImported.maxMatchesInSearch;
     _pCtConfig->toolbarIconSize = ctConfigImported.toolbarIconSize;
     _pCtConfig->currColour_fg = ctConfigImported.currColour_fg;
     _pCtConfig->currColour_bg = ctConfigImported.currColour_bg;
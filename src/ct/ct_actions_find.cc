@@ -26,9 +26,13 @@
 #include <gtkmm/stock.h>
 #include <glibmm/regex.h>
 #include <regex>
+#include <thread>
+#include <condition_variable>
+#include <deque>
 #include "ct_image.h"
 #include "ct_dialogs.h"
 #include "ct_logging.h"
+#include "ct_storage_control.h"
 
 void CtActions::find_matches_store_reset()
 {
@@ -98,6 +102,7 @@ void CtActions::find_in_selected_node_ok_clicked()
     if (all_matches) {
         _s_state.match_store->deep_clear();
         _s_state.all_matches_first_in_node = true;
+        _pCtMainWin->get_status_bar().set_progress_stop(false);
     }
     CtTreeIter::clear_hit_exclusion_from_search();
 
@@ -113,7 +118,11 @@ void CtActions::find_in_selected_node_ok_clicked()
     {
         ++_s_state.matches_num;
         if (not all_matches) break;
+        _check_max_matches();
+        if (_pCtMainWin->get_status_bar().is_progress_stop()) break;
     }
+    _pCtMainWin->get_status_bar().set_progress_stop(false);
+    _replace_all_finalise_nodes();
     if (0 == _s_state.matches_num) {
         CtDialogs::no_matches_dialog(_pCtMainWin,
                                      "'" + _s_options.str_find + "'  -  0 " + _("Matches"),
@@ -192,6 +201,15 @@ void CtActions::find_in_multiple_nodes_ok_clicked()
         node_iter = forward ? ctTreeStore.get_iter_first() : ctTreeStore.get_tree_iter_last_sibling(ctTreeStore.get_store()->children());
     }
     _s_state.matches_num = 0;
+    _s_state.content_candidates.clear();
+    _s_state.index_candidates.reset();
+    if (_s_options.node_content and not _s_options.reg_exp and not _s_options.accent_insensitive) {
+        // a literal, whole word or start word search is a superset of the index substring match
+        std::unordered_set<gint64> node_ids;
+        if (_pCtMainWin->get_ct_storage()->get_nodes_may_contain(_s_state.curr_find_pattern, _s_options.match_case, node_ids)) {
+            _s_state.index_candidates = std::move(node_ids);
+        }
+    }
     if (all_matches) {
         _s_state.match_store->deep_clear();
     }
@@ -209,13 +227,24 @@ void CtActions::find_in_multiple_nodes_ok_clicked()
         ctStatusBar.progressBar.show();
         ctStatusBar.stopButton.show();
         ctStatusBar.set_progress_stop(false);
+        // the matches are shown while they are found
+        _s_state.match_store->stream_begin();
+        if (not _s_state.pMatchStoreDialog) {
+            CtDialogs::match_dialog(_s_options.str_find, _pCtMainWin, _s_state);
+        }
         while (gtk_events_pending()) gtk_main_iteration();
     }
     std::time_t search_start_time = std::time(nullptr);
+    std::optional<CtContentPrefetcher> optContentPrefetcher;
+    if (all_matches and _s_options.node_content) {
+        // every node is going to be visited, the content of the next ones is matched meanwhile in parallel
+        optContentPrefetcher.emplace(this, _get_content_matcher(re_pattern), node_iter, forward, _s_options.only_sel_n_subnodes);
+        _s_pContentPrefetcher = &optContentPrefetcher.value();
+    }
     while (node_iter) {
         _s_state.all_matches_first_in_node = true;
         CtTreeIter ct_node_iter = ctTreeStore.to_ct_tree_iter(node_iter);
-        if (_s_options.node_content) {
+        if (_s_options.node_content and _is_node_content_candidate(ct_node_iter, re_pattern)) {
             Glib::RefPtr<Gsv::Buffer> rTextBuffer = ct_node_iter.get_node_text_buffer();
             if (not rTextBuffer) {
                 CtDialogs::error_dialog(str::format(_("Failed to retrieve the content of the node '%s'"), ct_node_iter.get_node_name()), *_pCtMainWin);
@@ -224,7 +253,9 @@ void CtActions::find_in_multiple_nodes_ok_clicked()
         }
         while (_parse_given_node_content(ct_node_iter, re_pattern, forward, first_fromsel, all_matches)) {
             ++_s_state.matches_num;
-            if (not all_matches or ctStatusBar.is_progress_stop()) break;
+            if (not all_matches) break;
+            _check_max_matches();
+            if (ctStatusBar.is_progress_stop()) break;
         }
         ++_s_state.processed_nodes;
         if (1 == _s_state.matches_num and not all_matches) break;
@@ -249,6 +280,9 @@ void CtActions::find_in_multiple_nodes_ok_clicked()
             _update_all_matches_progress();
         }
     }
+    _s_pContentPrefetcher = nullptr;
+    optContentPrefetcher.reset();
+    _replace_all_finalise_nodes();
     std::time_t search_end_time = std::time(nullptr);
     spdlog::debug("Search took {} sec", search_end_time - search_start_time);
 
@@ -262,13 +296,19 @@ void CtActions::find_in_multiple_nodes_ok_clicked()
         ctTextView.scroll_to(curr_buffer->get_insert(), CtTextView::TEXT_SCROLL_MARGIN);
     }
     if (not _s_state.matches_num) {
+        if (all_matches and _s_state.pMatchStoreDialog) {
+            _s_state.pMatchStoreDialog->close();
+        }
         CtDialogs::no_matches_dialog(_pCtMainWin,
                                      "'" + _s_options.str_find + "'  -  0 " + _("Matches"),
                                      str::format(_("<b>The pattern '%s' was not found</b>"), str::xml_escape(_s_state.curr_find_pattern)));
     }
     else {
         if (all_matches) {
-            CtDialogs::match_dialog(_s_options.str_find, _pCtMainWin, _s_state);
+            if (not _s_state.pMatchStoreDialog) {
+                // hidden while the search was running
+                CtDialogs::match_dialog(_s_options.str_find, _pCtMainWin, _s_state);
+            }
         }
         else {
             ctTreeView.set_cursor_safe(last_iterated_node);
@@ -284,6 +324,7 @@ void CtActions::find_in_multiple_nodes_ok_clicked()
         ctStatusBar.progressBar.hide();
         ctStatusBar.stopButton.hide();
         ctStatusBar.set_progress_stop(false);
+        _s_state.match_store->stream_end();
     }
 }
 // Continue the previous search (a_node/in_selected_node/in_all_nodes)
@@ -368,7 +409,7 @@ bool CtActions::_parse_given_node_content(CtTreeIter node_iter,
         optFirstNode = false;
     }
     if (optFirstNode.has_value() and (not node_iter.get_node_is_excluded_from_search() or _s_options.override_exclusions)) {
-        if (_s_options.node_content) {
+        if (_s_options.node_content and _is_node_content_candidate(node_iter, re_pattern)) {
             if (_parse_node_content_iter(node_iter,
                                          node_iter.get_node_text_buffer(),
                                          re_pattern,
@@ -395,7 +436,7 @@ bool CtActions::_parse_given_node_content(CtTreeIter node_iter,
             while (child_iter and not _pCtMainWin->get_status_bar().is_progress_stop()) {
                 _s_state.all_matches_first_in_node = true;
                 CtTreeIter ct_node_iter = ctTreeStore.to_ct_tree_iter(child_iter);
-                if (_s_options.node_content) {
+                if (_s_options.node_content and _is_node_content_candidate(ct_node_iter, re_pattern)) {
                     Glib::RefPtr<Gsv::Buffer> rTextBuffer = ct_node_iter.get_node_text_buffer();
                     if (not rTextBuffer) {
                         CtDialogs::error_dialog(str::format(_("Failed to retrieve the content of the node '%s'"), ct_node_iter.get_node_name()), *_pCtMainWin);
@@ -404,7 +445,9 @@ bool CtActions::_parse_given_node_content(CtTreeIter node_iter,
                 }
                 while (_parse_given_node_content(ct_node_iter, re_pattern, forward, first_fromsel, all_matches)) {
                     _s_state.matches_num += 1;
-                    if (not all_matches or _pCtMainWin->get_status_bar().is_progress_stop()) break;
+                    if (not all_matches) break;
+                    _check_max_matches();
+                    if (_pCtMainWin->get_status_bar().is_progress_stop()) break;
                 }
                 if (_s_state.matches_num == 1 and not all_matches) break;
                 if (forward) child_iter = ++child_iter;
@@ -463,6 +506,9 @@ bool CtActions::_parse_node_name_n_tags_iter(CtTreeIter& node_iter,
             _pCtMainWin->get_text_view().grab_focus();
         }
         _s_state.matches_num += 1;
+        if (all_matches) {
+            _check_max_matches();
+        }
         return true;
     }
     return false;
@@ -492,7 +538,7 @@ bool CtActions::_parse_node_content_iter(const CtTreeIter& tree_iter,
 
     bool pattern_found = _find_pattern(tree_iter, text_buffer, re_pattern, start_iter, forward, all_matches);
 
-    if (_s_state.replace_active and pattern_found)
+    if (_s_state.replace_active and pattern_found and not all_matches)
         _pCtMainWin->update_window_save_needed(CtSaveNeededUpdType::nbuf, false/*new_machine_state*/, &tree_iter);
     return pattern_found;
 }
@@ -529,6 +575,16 @@ Gtk::TextIter CtActions::_get_inner_start_iter(Glib::RefPtr<Gtk::TextBuffer> tex
     return start_iter;
 }
 
+// Returns False if the node content is out of the search by the node metadata only (exclusion, time filter),
+// checked before its stored content is read or its text buffer is loaded
+bool CtActions::_is_node_content_search_eligible(const CtTreeIter& node_iter)
+{
+    if (node_iter.get_node_is_excluded_from_search() and not _s_options.override_exclusions) {
+        return false;
+    }
+    return _is_node_within_time_filter(node_iter);
+}
+
 //"""Returns True if the given node_iter is within the Time Filter"""
 bool CtActions::_is_node_within_time_filter(const CtTreeIter& node_iter)
 {
@@ -545,23 +601,333 @@ bool CtActions::_is_node_within_time_filter(const CtTreeIter& node_iter)
     return true;
 }
 
+// Returns False if the node content has no match, from the stored content if the text buffer
+// is not loaded (so that it is not needed to load it) or from the snapshot of the prefetch;
+// the text is matched only to skip nodes, the offsets of the matches always come from the text buffer
+bool CtActions::_is_node_content_candidate(const CtTreeIter& node_iter, Glib::RefPtr<Glib::Regex> re_pattern)
+{
+    if (not _is_node_content_search_eligible(node_iter)) {
+        return false;
+    }
+    const gint64 node_id = node_iter.get_node_id_data_holder();
+    const auto it = _s_state.content_candidates.find(node_id);
+    if (_s_state.content_candidates.end() != it) {
+        return it->second;
+    }
+    if (_s_pContentPrefetcher) {
+        if (const std::optional<bool> optHasMatch = _s_pContentPrefetcher->take(node_iter)) {
+            _s_state.content_candidates[node_id] = optHasMatch.value();
+            return optHasMatch.value();
+        }
+    }
+    if (node_iter.get_node_buffer_already_loaded()) {
+        return true;
+    }
+    if (_s_state.index_candidates.has_value() and 0u == _s_state.index_candidates->count(node_id)) {
+        return false;
+    }
+    CtStorageNodeRawText raw_text;
+    bool is_candidate{true};
+    if (_pCtMainWin->get_ct_storage()->get_delayed_raw_text(node_id, raw_text)) {
+        is_candidate = _raw_text_has_match(raw_text, _get_content_matcher(re_pattern));
+    }
+    _s_state.content_candidates[node_id] = is_candidate;
+    return is_candidate;
+}
+
+CtActions::CtContentMatcher CtActions::_get_content_matcher(Glib::RefPtr<Glib::Regex> re_pattern) const
+{
+    return CtContentMatcher{re_pattern, _s_literal_finder, _s_options.accent_insensitive, not _s_state.replace_active};
+}
+
+// Returns True if the pattern is found in the node stored content, safe to be called from worker threads
+/*static*/bool CtActions::_raw_text_has_match(CtStorageNodeRawText& raw_text, const CtContentMatcher& matcher)
+{
+    auto f_match = [&](Glib::ustring& text){
+        if (matcher.accent_insensitive) {
+            text = str::diacritical_to_ascii(text);
+        }
+        return matcher.literal_finder ? matcher.literal_finder->match(text) : matcher.re_pattern->match(text);
+    };
+    if (f_match(raw_text.text)) {
+        return true;
+    }
+    if (matcher.objects_too) {
+        for (Glib::ustring& obj_text : raw_text.objects_text) {
+            if (f_match(obj_text)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Matches the content of the nodes ahead of the walk of a multiple nodes find all: a bounded window of
+// the next nodes in the walk order is read on this thread (the storage is not thread safe), the stored
+// content of the nodes not loaded and a snapshot of the loaded buffers, and matched by the workers with
+// their own copy of the matcher; each text is freed once matched
+class CtActions::CtContentPrefetcher
+{
+public:
+    CtContentPrefetcher(CtActions* pCtActions,
+                        CtContentMatcher matcher,
+                        Gtk::TreeIter first_iter,
+                        const bool forward,
+                        const bool only_subtree);
+    ~CtContentPrefetcher();
+
+    // whether the node content may match, if the node was read ahead; the nodes before it in the window are dropped
+    std::optional<bool> take(const CtTreeIter& node_iter);
+
+private:
+    struct CtItem
+    {
+        gint64               node_id{0};
+        CtStorageNodeRawText raw_text;
+        bool                 raw_text_ok{false};
+        bool                 dropped{false};
+        bool                 done{false};
+        bool                 has_match{true}; // stays a candidate unless matched without success
+    };
+    void _fill();
+    void _advance_cursor();
+    void _worker();
+
+    const inline static size_t WINDOW_SIZE{128u};
+
+    CtActions* const                    _pCtActions;
+    const CtContentMatcher              _matcher;
+    const bool                          _forward;
+    Gtk::TreeIter                       _cursor;      // next node to read, in the walk order
+    Gtk::TreeIter                       _subtreeRoot; // set if the walk does not leave the first node subtree
+    std::deque<std::shared_ptr<CtItem>> _window;      // read and not yet taken, in the walk order
+    std::mutex                          _mutex;
+    std::condition_variable             _cv;
+    std::deque<std::shared_ptr<CtItem>> _toMatch;     // under _mutex
+    bool                                _stop{false}; // under _mutex
+    std::vector<std::thread>            _workers;
+};
+
+CtActions::CtContentPrefetcher::CtContentPrefetcher(CtActions* pCtActions,
+                                                    CtContentMatcher matcher,
+                                                    Gtk::TreeIter first_iter,
+                                                    const bool forward,
+                                                    const bool only_subtree)
+ : _pCtActions{pCtActions}
+ , _matcher{std::move(matcher)}
+ , _forward{forward}
+ , _cursor{first_iter}
+{
+    if (only_subtree) {
+        _subtreeRoot = first_iter;
+    }
+    size_t numWorkers = std::thread::hardware_concurrency();
+    if (0u == numWorkers) numWorkers = 4u;
+    for (size_t w = 0u; w < numWorkers; ++w) {
+        _workers.emplace_back(&CtContentPrefetcher::_worker, this);
+    }
+}
+
+CtActions::CtContentPrefetcher::~CtContentPrefetcher()
+{
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _stop = true;
+    }
+    _cv.notify_all();
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+std::optional<bool> CtActions::CtContentPrefetcher::take(const CtTreeIter& node_iter)
+{
+    const gint64 node_id = node_iter.get_node_id_data_holder();
+    const auto it = std::find_if(_window.begin(), _window.end(), [node_id](const std::shared_ptr<CtItem>& pItem){
+        return pItem->node_id == node_id;
+    });
+    if (_window.end() == it) {
+        // the walk is not where the window is, which restarts after this node
+        {
+            std::lock_guard<std::mutex> lock{_mutex};
+            for (std::shared_ptr<CtItem>& pItem : _window) {
+                pItem->dropped = true;
+            }
+            _toMatch.clear();
+        }
+        _window.clear();
+        _cursor = node_iter;
+        _advance_cursor();
+        _fill();
+        return std::nullopt;
+    }
+    std::shared_ptr<CtItem> pItem = *it;
+    bool match_here{false};
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        for (auto itPassed = _window.begin(); itPassed != it; ++itPassed) {
+            (*itPassed)->dropped = true;
+        }
+        const auto itToMatch = std::find(_toMatch.begin(), _toMatch.end(), pItem);
+        if (_toMatch.end() != itToMatch) {
+            // not yet picked up by a worker, no need to wait for one
+            _toMatch.erase(itToMatch);
+            match_here = true;
+        }
+    }
+    _window.erase(_window.begin(), std::next(it));
+    _fill();
+    if (match_here) {
+        if (pItem->raw_text_ok) {
+            pItem->has_match = _raw_text_has_match(pItem->raw_text, _matcher);
+        }
+        pItem->raw_text = CtStorageNodeRawText{};
+        return pItem->has_match;
+    }
+    std::unique_lock<std::mutex> lock{_mutex};
+    _cv.wait(lock, [&pItem](){ return pItem->done; });
+    return pItem->has_match;
+}
+
+void CtActions::CtContentPrefetcher::_fill()
+{
+    CtMainWin* pCtMainWin = _pCtActions->_pCtMainWin;
+    CtTreeStore& ctTreeStore = pCtMainWin->get_tree_store();
+    CtStorageControl* pCtStorageControl = pCtMainWin->get_ct_storage();
+    CtSearchState& s_state = _pCtActions->_s_state;
+    std::vector<std::shared_ptr<CtItem>> newItems;
+    while (_cursor and _window.size() + newItems.size() < WINDOW_SIZE and not pCtMainWin->get_status_bar().is_progress_stop()) {
+        CtTreeIter node_iter = ctTreeStore.to_ct_tree_iter(_cursor);
+        _advance_cursor();
+        if (not _pCtActions->_is_node_content_search_eligible(node_iter)) {
+            continue;
+        }
+        const gint64 node_id = node_iter.get_node_id_data_holder();
+        if (0u != s_state.content_candidates.count(node_id)) {
+            continue; // shared node already matched
+        }
+        if (not node_iter.get_node_buffer_already_loaded() and
+            s_state.index_candidates.has_value() and 0u == s_state.index_candidates->count(node_id))
+        {
+            s_state.content_candidates[node_id] = false;
+            continue;
+        }
+        auto pItem = std::make_shared<CtItem>();
+        pItem->node_id = node_id;
+        if (node_iter.get_node_buffer_already_loaded()) {
+            if (Glib::RefPtr<Gsv::Buffer> rTextBuffer = node_iter.get_node_text_buffer()) {
+                pItem->raw_text.text = rTextBuffer->get_text();
+                if (_matcher.objects_too) {
+                    for (CtAnchoredWidget* pAnchoredWidget : node_iter.get_anchored_widgets_fast()) {
+                        (void)pAnchoredWidget->visit_searchable_text([&pItem](std::string_view text, const size_t, const size_t){
+                            pItem->raw_text.objects_text.emplace_back(std::string{text});
+                            return false; // next
+                        });
+                    }
+                }
+                pItem->raw_text_ok = true;
+            }
+        }
+        else {
+            pItem->raw_text_ok = pCtStorageControl->get_delayed_raw_text(node_id, pItem->raw_text);
+        }
+        newItems.push_back(pItem);
+    }
+    if (newItems.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock{_mutex};
+        _toMatch.insert(_toMatch.end(), newItems.begin(), newItems.end());
+    }
+    _cv.notify_all();
+    _window.insert(_window.end(), newItems.begin(), newItems.end());
+}
+
+// Moves the cursor to the next node in the walk order: children first, then the next sibling in the
+// direction, else the next sibling of the closest ancestor that has one
+void CtActions::CtContentPrefetcher::_advance_cursor()
+{
+    CtTreeIter ct_tree_iter = _pCtActions->_pCtMainWin->get_tree_store().to_ct_tree_iter(_cursor);
+    if (not _cursor->children().empty() and
+        (not ct_tree_iter.get_node_children_are_excluded_from_search() or _pCtActions->_s_options.override_exclusions))
+    {
+        _cursor = _forward ? _cursor->children().begin() : --_cursor->children().end();
+        return;
+    }
+    while (_cursor) {
+        if (_subtreeRoot and _cursor == _subtreeRoot) {
+            _cursor = Gtk::TreeIter{};
+            return;
+        }
+        Gtk::TreeIter next_iter = _cursor;
+        if (_forward) { ++next_iter; }
+        else          { --next_iter; }
+        if (next_iter) {
+            _cursor = next_iter;
+            return;
+        }
+        _cursor = _cursor->parent();
+    }
+}
+
+void CtActions::CtContentPrefetcher::_worker()
+{
+    std::unique_lock<std::mutex> lock{_mutex};
+    while (true) {
+        _cv.wait(lock, [this](){ return _stop or not _toMatch.empty(); });
+        if (_stop) {
+            return;
+        }
+        std::shared_ptr<CtItem> pItem = std::move(_toMatch.front());
+        _toMatch.pop_front();
+        const bool dropped = pItem->dropped;
+        lock.unlock();
+        bool has_match{true};
+        if (not dropped and pItem->raw_text_ok) {
+            has_match = _raw_text_has_match(pItem->raw_text, _matcher);
+        }
+        pItem->raw_text = CtStorageNodeRawText{};
+        lock.lock();
+        pItem->has_match = has_match;
+        pItem->done = true;
+        _cv.notify_all();
+    }
+}
+
 Glib::RefPtr<Glib::Regex> CtActions::_create_re_pattern(Glib::ustring pattern)
 {
     if (_s_options.accent_insensitive) {
         pattern = str::diacritical_to_ascii(pattern);
     }
+    _s_literal_finder.reset();
     if (not _s_options.reg_exp) { // NOT REGULAR EXPRESSION
+        if (not pattern.empty()) {
+            // the nodes content is searched without the regex engine, the regex still serves names, tags and objects
+            _s_literal_finder.emplace(pattern, _s_options.match_case, _s_options.whole_word, _s_options.start_word);
+        }
         pattern = Glib::Regex::escape_string(pattern);     // backslashes all non alphanum chars => to not spoil re
         if (_s_options.whole_word)      // WHOLE WORD
             pattern = "\\b" + pattern + "\\b";
         else if (_s_options.start_word) // START WORD
             pattern = "\\b" + pattern;
     }
+    Glib::RegexCompileFlags re_flags = Glib::RegexCompileFlags::REGEX_MULTILINE;
+    if (not _s_options.match_case) { // CASE INSENSITIVE
+        re_flags |= Glib::RegexCompileFlags::REGEX_CASELESS;
+    }
+    const auto re_key = std::make_pair(pattern.raw(), static_cast<int>(re_flags));
+    const auto it_re = _s_re_cache.find(re_key);
+    if (it_re != _s_re_cache.end()) {
+        return it_re->second;
+    }
     try {
-        if (_s_options.match_case) // CASE SENSITIVE
-            return Glib::Regex::create(pattern, Glib::RegexCompileFlags::REGEX_MULTILINE);
-        else
-            return Glib::Regex::create(pattern, Glib::RegexCompileFlags::REGEX_MULTILINE | Glib::RegexCompileFlags::REGEX_CASELESS);
+        Glib::RefPtr<Glib::Regex> re_pattern = Glib::Regex::create(pattern, re_flags);
+        if (_s_re_cache.size() >= 32u) {
+            _s_re_cache.clear();
+        }
+        _s_re_cache[re_key] = re_pattern;
+        return re_pattern;
     }
     catch (Glib::RegexError& e) {
         CtDialogs::error_dialog(str::xml_escape(e.what()), *_pCtMainWin);
@@ -578,17 +944,35 @@ bool CtActions::_find_pattern(CtTreeIter tree_iter,
 {
     // Gtk::TextBuffer uses symbols positions
     // Glib::Regex uses byte positions
-    Glib::ustring text = text_buffer->get_text();
-    if (_s_options.accent_insensitive) {
-        text = str::diacritical_to_ascii(text);
+    // the text is extracted again only if the buffer changed since the previous step
+    _search_buffer_cache_set(text_buffer);
+    CtUtf8Cursor& text_cursor = _s_buffer_cache.textCursor;
+    if (not _s_buffer_cache.textValid or _s_buffer_cache.textFolded != _s_options.accent_insensitive) {
+        Glib::ustring buffer_text = text_buffer->get_text();
+        if (_s_options.accent_insensitive) {
+            buffer_text = str::diacritical_to_ascii(buffer_text);
+        }
+        text_cursor.set_text(std::move(buffer_text));
+        _s_buffer_cache.textValid = true;
+        _s_buffer_cache.textFolded = _s_options.accent_insensitive;
     }
+    const Glib::ustring& text = text_cursor.get_text();
 
     const int start_offset = start_iter.get_offset();
     const int start_num_objs = _get_num_objs_before_offset(text_buffer, start_offset);
+    const int start_byte = text_cursor.char_to_byte(start_offset - start_num_objs);
     std::pair<int, int> match_offsets{-1, -1};
-    if (forward) {
+    if (_s_literal_finder) {
+        if (forward) {
+            _s_literal_finder->find_forward(text, start_byte, match_offsets.first, match_offsets.second);
+        }
+        else {
+            _s_literal_finder->find_backward(text, start_byte, match_offsets.first, match_offsets.second);
+        }
+    }
+    else if (forward) {
         Glib::MatchInfo match_info;
-        if (re_pattern->match(text, str::symb_pos_to_byte_pos(text, start_offset) - start_num_objs/*start_position*/, match_info)) {
+        if (re_pattern->match(text, start_byte/*start_position*/, match_info)) {
             if (match_info.matches()) {
                 match_info.fetch_pos(0, match_offsets.first, match_offsets.second);
             }
@@ -596,15 +980,16 @@ bool CtActions::_find_pattern(CtTreeIter tree_iter,
     }
     else {
         Glib::MatchInfo match_info;
-        re_pattern->match(text, str::symb_pos_to_byte_pos(text, start_offset) - start_num_objs/*string_len*/, 0/*start_position*/, match_info);
+        re_pattern->match(text, start_byte/*string_len*/, 0/*start_position*/, match_info);
         while (match_info.matches()) {
             match_info.fetch_pos(0, match_offsets.first, match_offsets.second);
             match_info.next();
         }
     }
+    const std::pair<int, int> match_bytes = match_offsets;
     if (match_offsets.first != -1) {
-        match_offsets.first = str::byte_pos_to_symb_pos(text, match_offsets.first);
-        match_offsets.second = str::byte_pos_to_symb_pos(text, match_offsets.second);
+        match_offsets.first = text_cursor.byte_to_char(match_offsets.first);
+        match_offsets.second = text_cursor.byte_to_char(match_offsets.second);
     }
 
     std::pair<int,int> obj_match_offsets{-1, -1};
@@ -659,8 +1044,29 @@ bool CtActions::_find_pattern(CtTreeIter tree_iter,
         if (_s_options.reg_exp) {
             replacer_text = re_pattern->replace(origin_text, 0, replacer_text, static_cast<Glib::RegexMatchFlags>(0));
         }
+        if (all_matches and 0u == _s_state.replaced_nodes.count(tree_iter.get_node_id())) {
+            // first replacement in the node, the node is finalised once at the end of the replace all
+            Glib::RefPtr<Gtk::TextBuffer> rUserActionBuffer;
+            if (not tree_iter.get_node_is_rich_text()) {
+                rUserActionBuffer = text_buffer;
+                rUserActionBuffer->begin_user_action(); // a single undo step of the source buffer
+            }
+            _s_state.replaced_nodes[tree_iter.get_node_id()] = rUserActionBuffer;
+        }
+        // the cached text and anchors are updated here rather than collected again
+        _s_buffer_cache.bufferChangedConn.block();
         text_buffer->erase(sel_start, sel_end);
         text_buffer->insert(text_buffer->get_iter_at_offset(_s_state.latest_match_offsets.first), replacer_text);
+        _s_buffer_cache.bufferChangedConn.unblock();
+        const bool no_anchor_replaced = _anchors_offsets_shift(_s_state.latest_match_offsets.first,
+                                                               _s_state.latest_match_offsets.second,
+                                                               static_cast<int>(replacer_text.size()) - (_s_state.latest_match_offsets.second - _s_state.latest_match_offsets.first));
+        if (no_anchor_replaced and not _s_buffer_cache.textFolded) {
+            text_cursor.replace_bytes(match_bytes.first, match_bytes.second, replacer_text);
+        }
+        else {
+            _s_buffer_cache.textValid = false;
+        }
         _s_state.latest_match_offsets.second = _s_state.latest_match_offsets.first + replacer_text.size();
         _s_state.replace_subsequent = true;
         if (all_matches) {
@@ -669,9 +1075,9 @@ bool CtActions::_find_pattern(CtTreeIter tree_iter,
         else {
             _pCtMainWin->get_text_view().set_selection_at_offset_n_delta(_s_state.latest_match_offsets.first,
                                                                          static_cast<int>(replacer_text.size()));
+            _pCtMainWin->get_state_machine().update_state(tree_iter);
+            tree_iter.pending_edit_db_node_buff();
         }
-        _pCtMainWin->get_state_machine().update_state(tree_iter);
-        tree_iter.pending_edit_db_node_buff();
     }
     return true;
 }
@@ -679,42 +1085,38 @@ bool CtActions::_find_pattern(CtTreeIter tree_iter,
 // Search for the pattern in the given object
 Glib::ustring CtActions::_check_pattern_in_object(Glib::RefPtr<Glib::Regex> pattern, CtAnchoredWidget* obj)
 {
-    if (CtImageEmbFile* image = dynamic_cast<CtImageEmbFile*>(obj)) {
-        Glib::ustring text = image->get_file_name().string();
+    Glib::ustring obj_content;
+    (void)obj->visit_searchable_text([&](std::string_view text, const size_t rowIdx, const size_t colIdx){
+        bool is_match{false};
         if (_s_options.accent_insensitive) {
-            text = str::diacritical_to_ascii(text);
+            // the folding needs its own copy anyway
+            const Glib::ustring folded_text = str::diacritical_to_ascii(Glib::ustring{std::string{text}});
+            is_match = _s_literal_finder ? _s_literal_finder->match(folded_text) : pattern->match(folded_text);
         }
-        if (pattern->match(text)) return text;
-    }
-    else if (CtImageAnchor* image = dynamic_cast<CtImageAnchor*>(obj)) {
-        Glib::ustring text = image->get_anchor_name();
-        if (_s_options.accent_insensitive) {
-            text = str::diacritical_to_ascii(text);
+        else if (_s_literal_finder) {
+            is_match = _s_literal_finder->match(text);
         }
-        if (pattern->match(text)) return text;
-    }
-    else if (auto table = dynamic_cast<CtTableCommon*>(obj)) {
-        std::vector<std::vector<Glib::ustring>> rows;
-        table->write_strings_matrix(rows);
-        for (auto& row : rows) {
-            for (Glib::ustring& col : row) {
-                if (_s_options.accent_insensitive) {
-                    col = str::diacritical_to_ascii(col);
-                }
-                if (pattern->match(col)) {
-                    return "<table>";
-                }
-            }
+        else {
+            is_match = g_regex_match_full(pattern->gobj(), text.data(), static_cast<gssize>(text.size()), 0, static_cast<GRegexMatchFlags>(0), nullptr, nullptr);
         }
-    }
-    else if (CtCodebox* codebox = dynamic_cast<CtCodebox*>(obj)) {
-        Glib::ustring text = codebox->get_text_content();
-        if (_s_options.accent_insensitive) {
-            text = str::diacritical_to_ascii(text);
+        if (not is_match) {
+            return false; // next cell
         }
-        if (pattern->match(text)) return "<codebox>";
-    }
-    return "";
+        switch (obj->get_type()) {
+            case CtAnchWidgType::TableHeavy:
+            case CtAnchWidgType::TableLight: {
+                obj_content = "<table> [" + std::to_string(rowIdx + 1) + CtConst::CHAR_COMMA + std::to_string(colIdx + 1) + "]";
+            } break;
+            case CtAnchWidgType::CodeBox: {
+                obj_content = "<codebox>";
+            } break;
+            default: {
+                obj_content = std::string{text};
+            } break;
+        }
+        return true;
+    });
+    return obj_content;
 }
 
 // Search for the pattern in the given slice and direction
@@ -749,26 +1151,64 @@ std::pair<int, int> CtActions::_check_pattern_in_object_between(CtTreeIter tree_
 }
 
 // Returns the num of objects from buffer start to the given offset
+// (max_offset is counted as if the objects before it were not in the buffer)
 int CtActions::_get_num_objs_before_offset(Glib::RefPtr<Gtk::TextBuffer> text_buffer, int max_offset)
 {
-    int num_objs = 0;
-    int local_limit_offset = max_offset;
-    Gtk::TextIter curr_iter = text_buffer->get_iter_at_offset(0);
-    int curr_offset = curr_iter.get_offset();
-    while (curr_offset <= local_limit_offset) {
-        auto anchor = curr_iter.get_child_anchor();
-        if (anchor) {
-            num_objs += 1;
-            local_limit_offset += 1;
-        }
-        if (not curr_iter.forward_char())
-            break;
-        int next_offset = curr_iter.get_offset();
-        if (next_offset == curr_offset)
-            break;
-        curr_offset = next_offset;
+    _search_buffer_cache_set(text_buffer);
+    std::vector<int>& anchors_text_offsets = _s_buffer_cache.anchorsTextOffsets;
+    if (not _s_buffer_cache.anchorsValid) {
+        // collected once per buffer change, then each lookup is a binary search
+        _s_buffer_cache.anchorsValid = true;
+        anchors_text_offsets.clear();
+        Gtk::TextIter curr_iter = text_buffer->begin();
+        auto f_add_if_anchor = [&](){
+            if (curr_iter.get_child_anchor()) {
+                anchors_text_offsets.push_back(curr_iter.get_offset() - static_cast<int>(anchors_text_offsets.size()));
+            }
+        };
+        f_add_if_anchor();
+        while (curr_iter.forward_find_char([](gunichar ch){ return 0xFFFC == ch; })) {
+            f_add_if_anchor();
+        }
     }
-    return num_objs;
+    return static_cast<int>(std::upper_bound(anchors_text_offsets.begin(), anchors_text_offsets.end(), max_offset) - anchors_text_offsets.begin());
+}
+
+// Keeps the anchors offsets in sync with a replacement of the buffer range start_offset..end_offset,
+// returns false if an anchor was in the replaced range
+bool CtActions::_anchors_offsets_shift(const int start_offset, const int end_offset, const int delta)
+{
+    if (not _s_buffer_cache.anchorsValid) {
+        return true;
+    }
+    std::vector<int>& anchors_text_offsets = _s_buffer_cache.anchorsTextOffsets;
+    for (size_t i = 0; i < anchors_text_offsets.size(); ++i) {
+        const int anchor_offset = anchors_text_offsets[i] + static_cast<int>(i);
+        if (anchor_offset < start_offset) continue;
+        if (anchor_offset < end_offset) {
+            // collect again at next lookup
+            _s_buffer_cache.anchorsValid = false;
+            return false;
+        }
+        anchors_text_offsets[i] += delta;
+    }
+    return true;
+}
+
+// Points the search buffer cache to text_buffer, any change to it from outside the search drops the cache
+void CtActions::_search_buffer_cache_set(Glib::RefPtr<Gtk::TextBuffer> text_buffer)
+{
+    if (_s_buffer_cache.rBuffer == text_buffer) {
+        return;
+    }
+    _s_buffer_cache.bufferChangedConn.disconnect();
+    _s_buffer_cache.rBuffer = text_buffer;
+    _s_buffer_cache.textValid = false;
+    _s_buffer_cache.anchorsValid = false;
+    _s_buffer_cache.bufferChangedConn = text_buffer->signal_changed().connect([this](){
+        _s_buffer_cache.textValid = false;
+        _s_buffer_cache.anchorsValid = false;
+    });
 }
 
 // Returns the Line Content Given the Text Iter
@@ -813,6 +1253,43 @@ void CtActions::_update_all_matches_progress()
     if (_s_state.matches_num != _s_state.latest_matches) {
         _s_state.latest_matches = _s_state.matches_num;
         _pCtMainWin->get_status_bar().progressBar.set_text(std::to_string(_s_state.matches_num));
+        _s_state.match_store->stream_flush();
     }
     while (gtk_events_pending()) gtk_main_iteration();
 }
+
+// Once per node changed by a replace all: one undo state, the node flagged as modified
+void CtActions::_replace_all_finalise_nodes()
+{
+    if (_s_state.replaced_nodes.empty()) {
+        return;
+    }
+    // the user actions are closed on the buffers kept, even of a node removed meanwhile (events are
+    // processed during the replace all), and the nodes still in the tree are found again by their id
+    for (const auto& node_pair : _s_state.replaced_nodes) {
+        if (node_pair.second) {
+            node_pair.second->end_user_action();
+        }
+    }
+    CtTreeStore& ctTreeStore = _pCtMainWin->get_tree_store();
+    std::vector<CtTreeIter> replaced_iters;
+    ctTreeStore.get_store()->foreach_iter([&](const Gtk::TreeIter& iter) {
+        CtTreeIter tree_iter = ctTreeStore.to_ct_tree_iter(iter);
+        if (0u != _s_state.replaced_nodes.count(tree_iter.get_node_id())) {
+            replaced_iters.push_back(tree_iter);
+        }
+        return false; /* continue */
+    });
+    _s_state.replaced_nodes.clear();
+    for (CtTreeIter& tree_iter : replaced_iters) {
+        _pCtMainWin->update_window_save_needed(CtSaveNeededUpdType::nbuf, true/*new_machine_state*/, &tree_iter);
+    }
+}
+
+// Stops the search once the max number of matches from the preferences is reached
+void CtActions::_check_max_matches()
+{
+    if (_pCtConfig->maxMatchesInSearch > 0 and _s_state.matches_num >= _pCtConfig->maxMatchesInSearch) {
+        _pCtMainWin->get_status_bar().set_progress_stop(true);
+    }
+}
@@ -927,6 +927,18 @@ void CtActions::node_go_back()
     }
 }
 
+// Go to a Node Searched by Name
+void CtActions::node_quick_jump()
+{
+    if (not _is_there_selected_node_or_error()) return;
+    const gint64 node_id = CtDialogs::dialog_node_palette(_pCtMainWin);
+    if (node_id > 0) {
+        if (CtTreeIter node_iter = _pCtMainWin->get_tree_store().get_node_from_node_id(node_id)) {
+            _pCtMainWin->get_tree_view().set_cursor_safe(node_iter);
+        }
+    }
+}
+
 // Go to the Next Visited Node
 void CtActions::node_go_forward()
 {
@@ -0,0 +1,122 @@
+/*
+ * ct_buffer_blob.cc
+ *
+ * Copyright 2009-2024
+ * Giuseppe Penone <giuspen@gmail.com>
+ * Evgenii Gurianov <https://github.com/txe>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "ct_buffer_blob.h"
+#include "ct_state_machine.h"
+#include "ct_main_win.h"
+#include "ct_misc_utils.h"
+#include <algorithm>
+#include <map>
+
+void CtBufferBlob::encode(const CtConfig* const pCtConfig,
+                          const Glib::RefPtr<Gtk::TextBuffer>& rTextBuffer,
+                          const std::list<CtAnchoredWidget*>& widgets)
+{
+    _text.clear();
+    _spans.clear();
+    _attributesSets.clear();
+    _widgetStates.clear();
+
+    std::map<CtTagAttributes, guint32> attributes_idx_map;
+    CtTextIterUtil::SerializeFunc f_blob_serialize = [&](Gtk::TextIter& start_iter,
+                                                         Gtk::TextIter& end_iter,
+                                                         CtCurrAttributesMap& curr_attributes,
+                                                         CtListInfo*/*pCurrListInfo*/)
+    {
+        const Glib::ustring slot_text = start_iter.get_text(end_iter);
+        if (slot_text.empty()) {
+            return;
+        }
+        CtTagAttributes tag_attributes;
+        for (const std::string_view tag_property : CtConst::TAG_PROPERTIES) {
+            const auto it = curr_attributes.find(tag_property);
+            if (curr_attributes.end() != it and not it->second.empty()) {
+                tag_attributes.emplace_back(std::string{tag_property}, it->second);
+            }
+        }
+        guint32 attributes_idx{0u};
+        const auto it_idx = attributes_idx_map.find(tag_attributes);
+        if (attributes_idx_map.end() != it_idx) {
+            attributes_idx = it_idx->second;
+        }
+        else {
+            attributes_idx = static_cast<guint32>(_attributesSets.size());
+            attributes_idx_map[tag_attributes] = attributes_idx;
+            _attributesSets.push_back(std::move(tag_attributes));
+        }
+        _text += slot_text.raw();
+        if (not _spans.empty() and _spans.back().attributesIdx == attributes_idx) {
+            // adjacent runs with the same tags are merged
+            _spans.back().textBytes += static_cast<guint32>(slot_text.bytes());
+        }
+        else {
+            _spans.push_back(CtTagSpan{static_cast<guint32>(slot_text.bytes()), attributes_idx});
+        }
+    };
+    CtTextIterUtil::generic_process_slot(pCtConfig, 0, -1, rTextBuffer, f_blob_serialize);
+
+    for (CtAnchoredWidget* pAnchoredWidget : widgets) {
+        _widgetStates.push_back(pAnchoredWidget->get_state());
+    }
+}
+
+void CtBufferBlob::decode(CtMainWin* pCtMainWin,
+                          Glib::RefPtr<Gsv::Buffer> rTextBuffer,
+                          std::list<CtAnchoredWidget*>& widgets) const
+{
+    // tags names are resolved once per attributes set rather than once per run
+    std::vector<std::vector<Glib::ustring>> tags_names(_attributesSets.size());
+    for (size_t i = 0; i < _attributesSets.size(); ++i) {
+        for (const auto& curr_attribute : _attributesSets[i]) {
+            tags_names[i].push_back(pCtMainWin->get_text_tag_name_exist_or_create(curr_attribute.first, curr_attribute.second));
+        }
+    }
+    const char* pText = _text.c_str();
+    for (const CtTagSpan& tagSpan : _spans) {
+        const std::vector<Glib::ustring>& span_tags_names = tags_names.at(tagSpan.attributesIdx);
+        if (span_tags_names.empty()) {
+            rTextBuffer->insert(rTextBuffer->end(), pText, pText + tagSpan.textBytes);
+        }
+        else {
+            rTextBuffer->insert_with_tags_by_name(rTextBuffer->end(), Glib::ustring(pText, pText + tagSpan.textBytes), span_tags_names);
+        }
+        pText += tagSpan.textBytes;
+    }
+    // widgets go in after the text since their offsets count the anchors
+    for (const auto& widgetState : _widgetStates) {
+        CtAnchoredWidget* pAnchoredWidget = widgetState->to_widget(pCtMainWin);
+        pAnchoredWidget->insertInTextBuffer(rTextBuffer);
+        widgets.push_back(pAnchoredWidget);
+    }
+}
+
+bool CtBufferBlob::operator==(const CtBufferBlob& other) const
+{
+    return _text == other._text and
+           _spans == other._spans and
+           _attributesSets == other._attributesSets and
+           std::equal(_widgetStates.begin(), _widgetStates.end(), other._widgetStates.begin(), other._widgetStates.end(),
+                      [](const std::shared_ptr<CtAnchoredWidgetState>& lhs, const std::shared_ptr<CtAnchoredWidgetState>& rhs) {
+                          return lhs->equal(rhs);
+                      });
+}
@@ -0,0 +1,78 @@
+/*
+ * ct_buffer_blob.h
+ *
+ * Copyright 2009-2024
+ * Giuseppe Penone <giuspen@gmail.com>
+ * Evgenii Gurianov <https://github.com/txe>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "ct_types.h"
+#include <gtksourceviewmm/buffer.h>
+#include <glibmm/refptr.h>
+#include <memory>
+#include <vector>
+
+class CtMainWin;
+class CtConfig;
+class CtAnchoredWidget;
+class CtAnchoredWidgetState;
+
+/**
+ * @brief Compact in-process copy of a rich text buffer
+ * The text is kept as a single UTF-8 string with run-length tag spans on top of it,
+ * plus the anchored widgets states. Used by the hot internal copy paths
+ * (undo snapshots, node duplication) in place of the xml round trip.
+ * @warning It is not an on-disk format, tags are kept as property/value pairs
+ * and resolved against the tag table of the target window on decode
+ */
+class CtBufferBlob
+{
+public:
+    using CtTagAttributes = std::vector<std::pair<std::string, std::string>>;
+
+    struct CtTagSpan
+    {
+        guint32 textBytes{0u};     // bytes of _text covered by this run
+        guint32 attributesIdx{0u}; // index in _attributesSets
+        bool operator==(const CtTagSpan& other) const {
+            return textBytes == other.textBytes and attributesIdx == other.attributesIdx;
+        }
+    };
+
+    void encode(const CtConfig* const pCtConfig,
+                const Glib::RefPtr<Gtk::TextBuffer>& rTextBuffer,
+                const std::list<CtAnchoredWidget*>& widgets);
+    void decode(CtMainWin* pCtMainWin,
+                Glib::RefPtr<Gsv::Buffer> rTextBuffer,
+                std::list<CtAnchoredWidget*>& widgets) const;
+
+    bool operator==(const CtBufferBlob& other) const;
+    bool operator!=(const CtBufferBlob& other) const { return not (*this == other); }
+
+    const std::string& get_text() const { return _text; }
+    size_t get_num_spans() const { return _spans.size(); }
+    size_t get_num_widgets() const { return _widgetStates.size(); }
+
+private:
+    std::string                                        _text;
+    std::vector<CtTagSpan>                             _spans;
+    std::vector<CtTagAttributes>                       _attributesSets;
+    std::list<std::shared_ptr<CtAnchoredWidgetState>>  _widgetStates;
+};
@@ -101,6 +101,15 @@ Glib::ustring CtTextCell::get_text_content() const
     return start_iter.get_text(end_iter);
 }
 
+bool CtTextCell::visit_text_content(const std::function<bool(std::string_view text)>& f_view) const
+{
+    // the buffer has no contiguous storage: a single transient copy, freed after the call
+    GtkTextIter start_iter, end_iter;
+    gtk_text_buffer_get_bounds(GTK_TEXT_BUFFER(_rTextBuffer->gobj()), &start_iter, &end_iter);
+    g_autofree gchar* pText = gtk_text_buffer_get_text(GTK_TEXT_BUFFER(_rTextBuffer->gobj()), &start_iter, &end_iter, TRUE/*include_hidden_chars*/);
+    return f_view(pText ? std::string_view{pText} : std::string_view{});
+}
+
 void CtTextCell::set_syntax_highlighting(const std::string& syntaxHighlighting, Gsv::LanguageManager* pGsvLanguageManager)
 {
     _syntaxHighlighting = syntaxHighlighting;
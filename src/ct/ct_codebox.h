@@ -38,6 +38,8 @@ public:
     virtual ~CtTextCell() {}
 
     Glib::ustring get_text_content() const;
+    // passes to f_view the whole text of the buffer, without copying it into a Glib::ustring
+    bool visit_text_content(const std::function<bool(std::string_view text)>& f_view) const;
     Glib::RefPtr<Gsv::Buffer> get_buffer() const { return _rTextBuffer; }
     CtTextView& get_text_view() { return _ctTextview; }
     const std::string& get_syntax_highlighting() const { return _syntaxHighlighting; }
@@ -81,6 +83,7 @@ public:
     void set_modified_false() override { set_text_buffer_modified_false(); }
     CtAnchWidgType get_type() const override { return CtAnchWidgType::CodeBox; }
     std::shared_ptr<CtAnchoredWidgetState> get_state() override;
+    bool visit_searchable_text(const SearchableTextVisitor& f_visit) const override { return visit_text_content([&f_visit](std::string_view text){ return f_visit(text, 0u, 0u); }); }
 
     void set_width_height(int newWidth, int newHeight);
     void set_width_in_pixels(const bool widthInPixels) { _widthInPixels = widthInPixels; }
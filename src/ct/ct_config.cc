@@ -227,6 +227,7 @@ void CtConfig::_populate_keyfile_from_data()
     _uKeyFile->set_boolean(_currentGroup, "show_node_name_header", showNodeNameHeader);
     _uKeyFile->set_integer(_currentGroup, "nodes_on_node_name_header", nodesOnNodeNameHeader);
     _uKeyFile->set_integer(_currentGroup, "max_matches_in_page", maxMatchesInPage);
+    _uKeyFile->set_integer(_currentGroup, "max_matches_in_search", maxMatchesInSearch);
     _uKeyFile->set_integer(_currentGroup, "toolbar_icon_size", toolbarIconSize);
     if (not currColour_fg.empty()) _uKeyFile->set_string(_currentGroup, "fg", currColour_fg);
     if (not currColour_bg.empty()) _uKeyFile->set_string(_currentGroup, "bg", currColour_bg);
@@ -503,6 +504,7 @@ void CtConfig::_populate_data_from_keyfile()
     _populate_bool_from_keyfile("show_node_name_header", &showNodeNameHeader);
     _populate_int_from_keyfile("nodes_on_node_name_header", &nodesOnNodeNameHeader);
     _populate_int_from_keyfile("max_matches_in_page", &maxMatchesInPage);
+    _populate_int_from_keyfile("max_matches_in_search", &maxMatchesInSearch);
     _populate_int_from_keyfile("toolbar_icon_size", &toolbarIconSize);
     _populate_string_from_keyfile("fg", &currColour_fg);
     _populate_string_from_keyfile("bg", &currColour_bg);
@@ -82,6 +82,7 @@ public:
     bool                                        showNodeNameHeader{true};
     int                                         nodesOnNodeNameHeader{3};
     int                                         maxMatchesInPage{500};
+    int                                         maxMatchesInSearch{0};
     int                                         toolbarIconSize{1};
     Glib::ustring                               currColour_fg;
     Glib::ustring                               currColour_bg;
@@ -140,6 +140,13 @@ public:
     std::string get_next_page_range();
     std::string get_prev_page_range();
 
+    // while the search is running, the matches found so far are shown at every flush
+    void stream_begin();
+    void stream_flush();
+    void stream_end();
+    bool is_streaming() const { return _streaming; }
+    sigc::signal<void> signal_streamed; // emitted at every flush and at the end
+
 private:
     CtMatchDialogStore(const size_t maxMatchesInPage)
      : cMaxMatchesInPage{maxMatchesInPage}
@@ -147,6 +154,8 @@ private:
     Gtk::TreeIter _add_row(const CtMatchRowData& row_data);
 
     int                         _page_idx{0};
+    size_t                      _page_rows_loaded{0};
+    bool                        _streaming{false};
     std::vector<CtMatchRowData> _all_matches;
 };
 
@@ -288,6 +297,9 @@ void dialog_about(Gtk::Window& parent, Glib::RefPtr<Gdk::Pixbuf> icon);
 
 std::string dialog_palette(CtMainWin* pCtMainWin);
 
+// Quick jump to a node by name, returns the node id or -1
+gint64 dialog_node_palette(CtMainWin* pCtMainWin);
+
 void summary_info_dialog(CtMainWin* pCtMainWin, const CtSummaryInfo& summaryInfo);
 
 enum class TableHandleResp { Cancel, Ok, OkFromFile };
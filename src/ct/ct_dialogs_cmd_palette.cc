@@ -24,61 +24,37 @@
 #include "ct_dialogs.h"
 #include "ct_main_win.h"
 
-std::string CtDialogs::dialog_palette(CtMainWin* pCtMainWin)
-{
-    // based on plotinus
-    struct CtPaletteColumns : public Gtk::TreeModelColumnRecord
-    {
-        Gtk::TreeModelColumn<int>           order;
-        Gtk::TreeModelColumn<Glib::ustring> id;
-        Gtk::TreeModelColumn<Glib::ustring> path;
-        Gtk::TreeModelColumn<Glib::ustring> label;
-        Gtk::TreeModelColumn<Glib::ustring> accelerator;
-        CtPaletteColumns() { add(order); add(id); add(path); add(label); add(accelerator); }
-    } columns;
+namespace {
 
-    Glib::ustring filter;
-    std::vector<Glib::ustring> filter_words;
+struct CtPaletteFilter
+{
+    Glib::ustring              text;  // lowercase, single spaced
+    std::vector<Glib::ustring> words;
+};
 
-    auto get_command_score = [&](const Gtk::TreeIter& iter) -> int {
-        auto label = iter->get_value(columns.label).lowercase();
-        auto path = iter->get_value(columns.path).lowercase();
-        int score = 0;
-        if (str::startswith(label, filter)) return score;
-        score++;
-        if (label.find(filter) != Glib::ustring::npos) return score;
-        score++;
-        if (CtStrUtil::contains_words(label, filter_words)) return score;
-        score++;
-        if (CtStrUtil::contains_words(label, filter_words, false)) return score;
-        score++;
-        if (CtStrUtil::contains_words(path, filter_words)) return score;
-        score++;
-        if (CtStrUtil::contains_words(path, filter_words, false)) return score;
-         return -1;
-    };
+struct CtPaletteColumn
+{
+    enum class Color { Default, Dimmed, Selection };
+    std::function<Glib::ustring(const Gtk::TreeIter&)> markup_function;
+    bool                                               align_right;
+    Color                                              color;
+    double                                             font_scale;
+};
 
-    auto list_store = Gtk::ListStore::create(columns);
-    int order_cnt = 0;
-    for (auto& action: pCtMainWin->get_ct_menu().get_actions())
-    {
-        if (action.category.empty()) continue;
-        auto iter = *list_store->append();
-        iter[columns.order] = ++order_cnt;
-        iter[columns.id] = action.id;
-        iter[columns.path] = action.category;
-        iter[columns.label] = str::replace(action.name, "_", "");
-        iter[columns.accelerator] = action.get_shortcut(pCtMainWin->get_ct_config());
-    }
+// based on plotinus: a search entry over a list in a popup, f_apply_filter updating the list in model at every
+// change of the filter; returns the activated row, empty if none
+Gtk::TreeIter run_palette_dialog(CtMainWin* pCtMainWin,
+                                 Glib::RefPtr<Gtk::TreeModel> model,
+                                 const std::vector<CtPaletteColumn>& palette_columns,
+                                 CtPaletteFilter& filter,
+                                 const std::function<void()>& f_apply_filter,
+                                 const int default_width,
+                                 const int x_offset)
+{
+    static const Glib::RefPtr<Glib::Regex> rRepeatedSpaces = Glib::Regex::create("\\s{2,}");
 
-    auto tree_model_filter = Gtk::TreeModelFilter::create(list_store);
-    tree_model_filter->set_visible_func([&](const Gtk::TreeIter& iter) -> bool {
-        if (filter.empty()) return true;
-        return get_command_score(iter) >= 0;
-    });
-    auto tree_model_sort = Gtk::TreeModelSort::create(tree_model_filter);
     auto tree_view = Gtk::TreeView();
-    tree_view.set_model(tree_model_sort);
+    tree_view.set_model(model);
     tree_view.set_headers_visible(false);
 
     // The theme's style context is reliably available only after the widget has been realized
@@ -88,47 +64,21 @@ std::string CtDialogs::dialog_palette(CtMainWin* pCtMainWin)
         auto selection_color = style_context->get_background_color(Gtk::StateFlags::STATE_FLAG_SELECTED | Gtk::StateFlags::STATE_FLAG_FOCUSED);
         text_color.set_alpha(0.4);
 
-        auto append_column = [&](std::function<Glib::ustring(const Gtk::TreeIter& iter)> markup_function, bool align_right, Gdk::RGBA* text_color, double font_scale = 1) {
+        for (const CtPaletteColumn& palette_column : palette_columns) {
             auto cell_renderer = Gtk::manage(new Gtk::CellRendererText());
-            if (align_right) cell_renderer->property_xalign() = 1;
-            if (text_color != nullptr) cell_renderer->property_foreground_rgba() = *text_color;
-            cell_renderer->property_scale() = font_scale;
+            if (palette_column.align_right) cell_renderer->property_xalign() = 1;
+            if (CtPaletteColumn::Color::Dimmed == palette_column.color) cell_renderer->property_foreground_rgba() = text_color;
+            else if (CtPaletteColumn::Color::Selection == palette_column.color) cell_renderer->property_foreground_rgba() = selection_color;
+            cell_renderer->property_scale() = palette_column.font_scale;
             auto column = Gtk::manage(new Gtk::TreeViewColumn());
             column->pack_start(*cell_renderer, true);
-            column->set_cell_data_func(*cell_renderer, [markup_function](Gtk::CellRenderer* cell, const Gtk::TreeIter& iter){
+            column->set_cell_data_func(*cell_renderer, [markup_function=palette_column.markup_function](Gtk::CellRenderer* cell, const Gtk::TreeIter& iter){
                 ((Gtk::CellRendererText*)cell)->property_markup() = markup_function(iter);
             });
             tree_view.append_column(*column);
-        };
-        append_column([&](const Gtk::TreeIter& iter) -> Glib::ustring {
-            return "  " + CtStrUtil::highlight_words(iter->get_value(columns.path), filter_words) + "  ";
-        }, true, &text_color);
-        append_column([&](const Gtk::TreeIter& iter) -> Glib::ustring {
-            return CtStrUtil::highlight_words(iter->get_value(columns.label), filter_words);
-        }, false, nullptr, 1.4);
-        append_column([&](const Gtk::TreeIter& iter) -> Glib::ustring {
-            return "  " + str::xml_escape(CtStrUtil::get_accelerator_label(iter->get_value(columns.accelerator))) + "  ";
-        }, true, &selection_color);
+        }
     });
 
-    auto set_filter = [&] (const Glib::ustring& raw_filter) {
-        filter = Glib::Regex::create("/\\s{2,}/")->replace(raw_filter.c_str(), -1, 0, " ");
-        filter = str::trim(filter).lowercase();
-        filter_words = str::split(filter, " ");
-
-        tree_model_filter->refilter();
-
-        // TreeModelSort has no "resort" method, but reassigning the comparison function forces a resort
-        tree_model_sort->set_default_sort_func([&](const Gtk::TreeIter& iter_a, const Gtk::TreeIter& iter_b) {
-          // "The sort function used by TreeModelSort is not guaranteed to be stable" (GTK+ documentation),
-          // so the original order of commands is needed as a tie-breaker
-          int id_difference = iter_a->get_value(columns.order) - iter_b->get_value(columns.order);
-          if (filter.empty()) return id_difference;
-
-          int score_difference = get_command_score(iter_a) - get_command_score(iter_b);
-          return (score_difference != 0) ? score_difference : id_difference;
-        });
-    };
     auto scroll_to_selected_item = [&]() {
         if (Gtk::TreeIter selected_iter = tree_view.get_selection()->get_selected()) {
             auto selected_path = tree_view.get_model()->get_path(selected_iter);
@@ -160,7 +110,7 @@ std::string CtDialogs::dialog_palette(CtMainWin* pCtMainWin)
     popup_dialog.set_transient_for(*pCtMainWin);
     popup_dialog.set_position(Gtk::WindowPosition::WIN_POS_CENTER_ON_PARENT);
     popup_dialog.set_skip_taskbar_hint(true);
-    popup_dialog.set_default_size(-1, 200);
+    popup_dialog.set_default_size(default_width, 200);
     popup_dialog.set_size_request(-1, 350);
 
     // Width is determined by the width of the search entry/command list
@@ -186,7 +136,11 @@ std::string CtDialogs::dialog_palette(CtMainWin* pCtMainWin)
     search_entry.property_margin() = 4;
     header_bar.set_custom_title(search_entry);
     search_entry.signal_changed().connect([&]() {
-        set_filter(search_entry.get_text());
+        const Glib::ustring raw_filter = search_entry.get_text();
+        filter.text = rRepeatedSpaces->replace(raw_filter.c_str(), -1, 0, " ");
+        filter.text = str::trim(filter.text).lowercase();
+        filter.words = str::split(filter.text, " ");
+        f_apply_filter();
         select_first_item();
     });
 
@@ -197,7 +151,7 @@ std::string CtDialogs::dialog_palette(CtMainWin* pCtMainWin)
             popup_dialog.close();
         }
     };
-    auto entry_activated = search_entry.signal_activate().connect([&]() {
+    search_entry.signal_activate().connect([&]() {
         run_command();
     });
     tree_view.signal_row_activated().connect([&](const Gtk::TreeModel::Path&, Gtk::TreeViewColumn* ) {
@@ -229,11 +183,147 @@ std::string CtDialogs::dialog_palette(CtMainWin* pCtMainWin)
     pCtMainWin->get_position(root_x, root_y);
     pCtMainWin->get_size(width_1, height_1);
     popup_dialog.get_size(width_2, height_2);
-    popup_dialog.move(root_x + (width_1 - width_2) / 2 - 150, root_y + (height_1 - height_2)/2 - 50);
+    popup_dialog.move(root_x + (width_1 - width_2) / 2 + x_offset, root_y + (height_1 - height_2)/2 - 50);
 
     popup_dialog.run();
 
+    return resulted_iter;
+}
+
+} // namespace (anonymous)
+
+std::string CtDialogs::dialog_palette(CtMainWin* pCtMainWin)
+{
+    struct CtPaletteColumns : public Gtk::TreeModelColumnRecord
+    {
+        Gtk::TreeModelColumn<int>           order;
+        Gtk::TreeModelColumn<Glib::ustring> id;
+        Gtk::TreeModelColumn<Glib::ustring> path;
+        Gtk::TreeModelColumn<Glib::ustring> label;
+        Gtk::TreeModelColumn<Glib::ustring> accelerator;
+        CtPaletteColumns() { add(order); add(id); add(path); add(label); add(accelerator); }
+    } columns;
+
+    CtPaletteFilter filter;
+
+    auto get_command_score = [&](const Gtk::TreeIter& iter) -> int {
+        auto label = iter->get_value(columns.label).lowercase();
+        auto path = iter->get_value(columns.path).lowercase();
+        int score = 0;
+        if (str::startswith(label, filter.text)) return score;
+        score++;
+        if (label.find(filter.text) != Glib::ustring::npos) return score;
+        score++;
+        if (CtStrUtil::contains_words(label, filter.words)) return score;
+        score++;
+        if (CtStrUtil::contains_words(label, filter.words, false)) return score;
+        score++;
+        if (CtStrUtil::contains_words(path, filter.words)) return score;
+        score++;
+        if (CtStrUtil::contains_words(path, filter.words, false)) return score;
+         return -1;
+    };
+
+    auto list_store = Gtk::ListStore::create(columns);
+    int order_cnt = 0;
+    for (auto& action: pCtMainWin->get_ct_menu().get_actions())
+    {
+        if (action.category.empty()) continue;
+        auto iter = *list_store->append();
+        iter[columns.order] = ++order_cnt;
+        iter[columns.id] = action.id;
+        iter[columns.path] = action.category;
+        iter[columns.label] = str::replace(action.name, "_", "");
+        iter[columns.accelerator] = action.get_shortcut(pCtMainWin->get_ct_config());
+    }
+
+    auto tree_model_filter = Gtk::TreeModelFilter::create(list_store);
+    tree_model_filter->set_visible_func([&](const Gtk::TreeIter& iter) -> bool {
+        if (filter.text.empty()) return true;
+        return get_command_score(iter) >= 0;
+    });
+    auto tree_model_sort = Gtk::TreeModelSort::create(tree_model_filter);
+
+    auto apply_filter = [&]() {
+        tree_model_filter->refilter();
+
+        // TreeModelSort has no "resort" method, but reassigning the comparison function forces a resort
+        tree_model_sort->set_default_sort_func([&](const Gtk::TreeIter& iter_a, const Gtk::TreeIter& iter_b) {
+          // "The sort function used by TreeModelSort is not guaranteed to be stable" (GTK+ documentation),
+          // so the original order of commands is needed as a tie-breaker
+          int id_difference = iter_a->get_value(columns.order) - iter_b->get_value(columns.order);
+          if (filter.text.empty()) return id_difference;
+
+          int score_difference = get_command_score(iter_a) - get_command_score(iter_b);
+          return (score_difference != 0) ? score_difference : id_difference;
+        });
+    };
+
+    const Gtk::TreeIter resulted_iter = run_palette_dialog(pCtMainWin, tree_model_sort, {
+        {[&](const Gtk::TreeIter& iter) -> Glib::ustring {
+            return "  " + CtStrUtil::highlight_words(iter->get_value(columns.path), filter.words) + "  ";
+        }, true/*align_right*/, CtPaletteColumn::Color::Dimmed, 1},
+        {[&](const Gtk::TreeIter& iter) -> Glib::ustring {
+            return CtStrUtil::highlight_words(iter->get_value(columns.label), filter.words);
+        }, false/*align_right*/, CtPaletteColumn::Color::Default, 1.4},
+        {[&](const Gtk::TreeIter& iter) -> Glib::ustring {
+            return "  " + str::xml_escape(CtStrUtil::get_accelerator_label(iter->get_value(columns.accelerator))) + "  ";
+        }, true/*align_right*/, CtPaletteColumn::Color::Selection, 1}
+    }, filter, apply_filter, -1/*default_width*/, -150/*x_offset*/);
+
     if (resulted_iter)
         return resulted_iter->get_value(columns.id);
     return "";
 }
+
+gint64 CtDialogs::dialog_node_palette(CtMainWin* pCtMainWin)
+{
+    struct CtNodePaletteColumns : public Gtk::TreeModelColumnRecord
+    {
+        Gtk::TreeModelColumn<gint64>        node_id;
+        Gtk::TreeModelColumn<Glib::ustring> path;
+        Gtk::TreeModelColumn<Glib::ustring> label;
+        CtNodePaletteColumns() { add(node_id); add(path); add(label); }
+    } columns;
+    const size_t maxResults{100};
+
+    CtTreeStore& ctTreeStore = pCtMainWin->get_tree_store();
+    CtPaletteFilter filter;
+    // the tree cannot change while the modal dialog is open
+    std::unordered_map<gint64, Gtk::TreeIter> nodes_iters;
+    ctTreeStore.get_store()->foreach_iter([&](const Gtk::TreeIter& iter) {
+        nodes_iters[iter->get_value(ctTreeStore.get_columns().colNodeUniqueId)] = iter;
+        return false; /* continue */
+    });
+
+    // the list holds only the ranked results, answered from the node names index at every keystroke
+    auto list_store = Gtk::ListStore::create(columns);
+    auto apply_filter = [&]() {
+        list_store->clear();
+        for (const gint64 node_id : ctTreeStore.node_names_quick_find(filter.text, maxResults)) {
+            const auto it = nodes_iters.find(node_id);
+            if (nodes_iters.end() == it) continue;
+            CtTreeIter node_iter = ctTreeStore.to_ct_tree_iter(it->second);
+            auto row = *list_store->append();
+            row[columns.node_id] = node_id;
+            CtTreeIter father_iter = node_iter.parent();
+            if (father_iter) {
+                row[columns.path] = CtMiscUtil::get_node_hierarchical_name(father_iter, " / ", false/*for_filename*/);
+            }
+            row[columns.label] = node_iter.get_node_name();
+        }
+    };
+
+    const Gtk::TreeIter resulted_iter = run_palette_dialog(pCtMainWin, list_store, {
+        {[&](const Gtk::TreeIter& iter) -> Glib::ustring {
+            return "  " + CtStrUtil::highlight_words(iter->get_value(columns.path), filter.words) + "  ";
+        }, true/*align_right*/, CtPaletteColumn::Color::Dimmed, 1},
+        {[&](const Gtk::TreeIter& iter) -> Glib::ustring {
+            return CtStrUtil::highlight_words(iter->get_value(columns.label), filter.words);
+        }, false/*align_right*/, CtPaletteColumn::Color::Default, 1.4}
+    }, filter, apply_filter, 600/*default_width*/, 0/*x_offset*/);
+
+    if (resulted_iter)
+        return resulted_iter->get_value(columns.node_id);
+    return -1;
+}
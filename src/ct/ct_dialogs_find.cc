@@ -378,6 +378,7 @@ void CtMatchDialogStore::deep_clear()
     clear();
     saved_path.clear();
     _page_idx = 0;
+    _page_rows_loaded = 0;
     _all_matches.clear();
 }
 
@@ -403,13 +404,12 @@ CtMatchRowData* CtMatchDialogStore::add_row(gint64 node_id,
 
 void CtMatchDialogStore::load_current_page()
 {
-    if (get_iter("0")) {
-        return; // already populated
-    }
+    // only the rows not yet loaded, the page can be partially populated while streaming
     const size_t iMax = (_page_idx + 1) * cMaxMatchesInPage;
-    for (size_t i = _page_idx * cMaxMatchesInPage; i < iMax; ++i) {
+    for (size_t i = _page_idx * cMaxMatchesInPage + _page_rows_loaded; i < iMax; ++i) {
         if (i >= _all_matches.size()) break;
         (void)_add_row(_all_matches.at(i));
+        ++_page_rows_loaded;
     }
 }
 
@@ -417,6 +417,7 @@ void CtMatchDialogStore::load_next_page()
 {
     if (not has_next_page()) return;
     clear();
+    _page_rows_loaded = 0;
     ++_page_idx;
     load_current_page();
 }
@@ -425,6 +426,7 @@ void CtMatchDialogStore::load_prev_page()
 {
     if (not has_prev_page()) return;
     clear();
+    _page_rows_loaded = 0;
     --_page_idx;
     load_current_page();
 }
@@ -474,6 +476,24 @@ std::string CtMatchDialogStore::get_prev_page_range()
     return fmt::format("{}..{}", match_idx_start + 1, match_idx_end + 1);
 }
 
+void CtMatchDialogStore::stream_begin()
+{
+    _streaming = true;
+    signal_streamed.emit();
+}
+
+void CtMatchDialogStore::stream_flush()
+{
+    load_current_page();
+    signal_streamed.emit();
+}
+
+void CtMatchDialogStore::stream_end()
+{
+    _streaming = false;
+    stream_flush();
+}
+
 Gtk::TreeIter CtMatchDialogStore::_add_row(const CtMatchRowData& row_data) {
     Gtk::TreeIter retIter = append();
     Gtk::TreeRow row = *retIter;
@@ -523,16 +543,15 @@ void CtDialogs::match_dialog(const std::string& str_find,
     pTreeview->set_tooltip_column(2/*rModel->columns.node_hier_name*/);
     auto pScrolledBox = Gtk::manage(new Gtk::Box{Gtk::ORIENTATION_VERTICAL, 3/*spacing*/});
     pScrolledBox->pack_start(*pTreeview);
-    if (CtTreeIter::get_hit_exclusion_from_search()) {
-        auto pHBoxExclusions = Gtk::manage(new Gtk::Box{Gtk::ORIENTATION_HORIZONTAL, 3/*spacing*/});
-        Gtk::Image* pImageExclusions = pCtMainWin->new_managed_image_from_stock("ct_ghost", Gtk::ICON_SIZE_BUTTON);
-        pImageExclusions->set_padding(3/*xpad*/, 0/*ypad*/);
-        pHBoxExclusions->pack_start(*pImageExclusions, false, false);
-        auto pLabelExclusions = Gtk::manage(new Gtk::Label{_("At least one node was skipped because of exclusions set in the node properties.\nIn order to clear all the exclusions, use the menu:\nSearch -> Clear All Exclusions From Search")});
-        pLabelExclusions->set_xalign(0.0);
-        pHBoxExclusions->pack_start(*pLabelExclusions);
-        pScrolledBox->pack_start(*pHBoxExclusions, false, false);
-    }
+    // shown once the search hits an exclusion, the dialog is built before or during the search
+    auto pHBoxExclusions = Gtk::manage(new Gtk::Box{Gtk::ORIENTATION_HORIZONTAL, 3/*spacing*/});
+    Gtk::Image* pImageExclusions = pCtMainWin->new_managed_image_from_stock("ct_ghost", Gtk::ICON_SIZE_BUTTON);
+    pImageExclusions->set_padding(3/*xpad*/, 0/*ypad*/);
+    pHBoxExclusions->pack_start(*pImageExclusions, false, false);
+    auto pLabelExclusions = Gtk::manage(new Gtk::Label{_("At least one node was skipped because of exclusions set in the node properties.\nIn order to clear all the exclusions, use the menu:\nSearch -> Clear All Exclusions From Search")});
+    pLabelExclusions->set_xalign(0.0);
+    pHBoxExclusions->pack_start(*pLabelExclusions);
+    pScrolledBox->pack_start(*pHBoxExclusions, false, false);
     auto pScrolledwindowAllmatches = Gtk::manage(new Gtk::ScrolledWindow{});
     pScrolledwindowAllmatches->set_policy(Gtk::POLICY_AUTOMATIC, Gtk::POLICY_AUTOMATIC);
     pScrolledwindowAllmatches->add(*pScrolledBox);
@@ -548,6 +567,8 @@ void CtDialogs::match_dialog(const std::string& str_find,
         if (not list_iter) {
             return;
         }
+        // while streaming the search goes on, the selected match is shown again once it is over
+        // as the search then restores the starting node
         gint64 node_id = list_iter->get_value(s_state.match_store->columns.node_id);
         CtTreeIter tree_iter = pCtMainWin->get_tree_store().get_node_from_node_id(node_id);
         if (not tree_iter) {
@@ -566,9 +587,11 @@ void CtDialogs::match_dialog(const std::string& str_find,
                                   rCurrBuffer->get_iter_at_offset(list_iter->get_value(s_state.match_store->columns.end_offset)));
         pCtMainWin->get_text_view().scroll_to(rCurrBuffer->get_insert(), CtTextView::TEXT_SCROLL_MARGIN);
 
-        // pump events so UI's not going to freeze (#835)
-        while (gdk_events_pending())
-            gtk_main_iteration();
+        // pump events so UI's not going to freeze (#835), the search loop does while streaming
+        if (not s_state.match_store->is_streaming()) {
+            while (gdk_events_pending())
+                gtk_main_iteration();
+        }
     };
 
     if (not rModel->saved_path.empty()) {
@@ -618,6 +641,15 @@ void CtDialogs::match_dialog(const std::string& str_find,
         }
     };
 
+    // the slot is dropped with the dialog
+    rModel->signal_streamed.connect(sigc::track_obj([&s_state, f_reEval_multipage, select_found_line, pHBoxExclusions](){
+        f_reEval_multipage();
+        pHBoxExclusions->set_visible(CtTreeIter::get_hit_exclusion_from_search());
+        if (not s_state.match_store->is_streaming()) {
+            select_found_line();
+        }
+    }, *pMatchesDialog));
+
     pButtonPrev->signal_clicked().connect([&s_state, f_reEval_multipage](){
         s_state.in_loading = true;
         s_state.match_store->load_prev_page();
@@ -632,6 +664,7 @@ void CtDialogs::match_dialog(const std::string& str_find,
     });
 
     pMatchesDialog->show_all();
+    pHBoxExclusions->set_visible(CtTreeIter::get_hit_exclusion_from_search());
     f_reEval_multipage();
 }
 
@@ -25,6 +25,15 @@
 #include <glib/gstdio.h>
 #include <curl/curl.h>
 #include <system_error>
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <linux/fs.h>
+#elif defined(__APPLE__)
+#include <sys/clonefile.h>
+#endif // __linux__ / __APPLE__
 #include <utility>
 #include <unordered_map>
 
@@ -192,6 +201,58 @@ bool copy_file(const path& from, const path& to)
     }
 }
 
+bool clone_file(const path& from, const path& to)
+{
+#if defined(__linux__)
+    const int fdFrom = ::open(from.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fdFrom < 0) {
+        return copy_file(from, to);
+    }
+    struct stat st;
+    if (::fstat(fdFrom, &st) != 0) {
+        ::close(fdFrom);
+        return copy_file(from, to);
+    }
+    const int fdTo = ::open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, st.st_mode & 0777);
+    if (fdTo < 0) {
+        ::close(fdFrom);
+        return copy_file(from, to);
+    }
+    bool done{false};
+#if defined(FICLONE)
+    // btrfs, xfs and the like share the extents, no data copied
+    done = 0 == ::ioctl(fdTo, FICLONE, fdFrom);
+#endif // FICLONE
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 27))
+    if (not done) {
+        // in kernel copy, server side on network filesystems
+        off_t left = st.st_size;
+        while (left > 0) {
+            const ssize_t copied = ::copy_file_range(fdFrom, nullptr, fdTo, nullptr, static_cast<size_t>(left), 0);
+            if (copied <= 0) break;
+            left -= copied;
+        }
+        done = 0 == left;
+    }
+#endif // glibc >= 2.27
+    ::close(fdFrom);
+    if (0 != ::close(fdTo)) {
+        done = false;
+    }
+    if (done) {
+        return true;
+    }
+    spdlog::debug("fs::clone_file, falling back to copy, from: {}, to: {}", from.string(), to.string());
+#elif defined(__APPLE__)
+    // apfs copy on write clone, the destination must not exist
+    (void)g_remove(to.c_str());
+    if (0 == ::clonefile(from.c_str(), to.c_str(), 0)) {
+        return true;
+    }
+#endif // __linux__ / __APPLE__
+    return copy_file(from, to);
+}
+
 bool move_file(const path& from, const path& to)
 {
     GFile* pGFile_from = g_file_new_for_path(from.c_str());
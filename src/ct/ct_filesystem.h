@@ -57,6 +57,12 @@ const char* get_latex_dvipng_console_bin_prefix();
 
 bool copy_file(const path& from, const path& to);
 
+/**
+* @brief Copy a file sharing its data blocks (reflink) where the filesystem supports it,
+* else with an in kernel copy, else with a streamed copy
+*/
+bool clone_file(const path& from, const path& to);
+
 bool move_file(const path& from, const path& to);
 
 bool exists(const path& filepath);
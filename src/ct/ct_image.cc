@@ -121,6 +121,9 @@ void CtImagePng::to_xml(xmlpp::Element* p_node_parent,
     p_image_node->set_attribute(CtConst::TAG_JUSTIFICATION, _justification);
     p_image_node->set_attribute("link", _link);
     if (multifile_dir.empty()) {
+        if (storage_cache and storage_cache->defer_image(this, p_image_node)) {
+            return;
+        }
         std::string encodedBlob;
         if (not storage_cache or not storage_cache->get_cached_image(this, encodedBlob)) {
             encodedBlob = Glib::Base64::encode(get_raw_blob());
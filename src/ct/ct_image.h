@@ -104,6 +104,7 @@ public:
     bool to_sqlite(sqlite3* pDb, const gint64 node_id, const int offset_adjustment, CtStorageCache* cache) override;
     CtAnchWidgType get_type() const override { return CtAnchWidgType::ImageAnchor; }
     std::shared_ptr<CtAnchoredWidgetState> get_state() override;
+    bool visit_searchable_text(const SearchableTextVisitor& f_visit) const override { return f_visit(_anchorName.raw(), 0u, 0u); }
 
     const Glib::ustring& get_anchor_name() { return _anchorName; }
 
@@ -176,6 +177,7 @@ public:
     bool to_sqlite(sqlite3* pDb, const gint64 node_id, const int offset_adjustment, CtStorageCache* cache) override;
     CtAnchWidgType get_type() const override { return CtAnchWidgType::ImageEmbFile; }
     std::shared_ptr<CtAnchoredWidgetState> get_state() override;
+    bool visit_searchable_text(const SearchableTextVisitor& f_visit) const override { return f_visit(_fileName.string(), 0u, 0u); }
 
     const fs::path&      get_file_name() const { return _fileName; }
     void                 set_file_name(const fs::path& path) { _fileName = path; }
@@ -198,6 +198,10 @@ CtMainWin::~CtMainWin()
 {
     _autosave_timout_connection.disconnect();
     _mod_time_sentinel_timout_connection.disconnect();
+    _mod_time_sentinel_check_connection.disconnect();
+    if (_rModTimeSentinelMonitor) {
+        _rModTimeSentinelMonitor->cancel();
+    }
     //std::cout << "~CtMainWin" << std::endl;
 }
 
@@ -692,6 +696,7 @@ void CtMainWin::reset()
     _ctStateMachine.reset();
 
     _uCtStorage.reset(CtStorageControl::create_dummy_storage(this));
+    mod_time_sentinel_restart();
 
     _reset_CtTreestore_CtTreeview();
 
@@ -101,7 +101,7 @@ public:
 
     bool file_open(const fs::path& filepath, const std::string& node_to_focus, const std::string& anchor_to_focus, const Glib::ustring password = "");
     bool file_save_ask_user();
-    bool file_save(const bool need_vacuum);
+    bool file_save(const bool need_vacuum, const bool allow_async = false);
     void file_save_as(const std::string& new_filepath, const CtDocType doc_type, const Glib::ustring& password);
     void file_autosave_restart();
     void mod_time_sentinel_restart();
@@ -216,12 +216,18 @@ public:
     void set_systray_can_hide(const bool systrayCanHide) { _systrayCanHide = systrayCanHide; }
     bool get_systray_can_hide() const { return _systrayCanHide; }
     void toggle_always_on_top() { _alwaysOnTop = not _alwaysOnTop; set_keep_above(_alwaysOnTop); }
-    void resetAutoSaveCounter() { if (_autoSaveCounter) { _autoSaveCounter = 0; spdlog::debug("autoSaveCounter->0"); } }
+    void resetAutoSaveDirtySince() { _autosaveDirtySinceUs = 0; }
 
 private:
     bool _on_window_key_press_event(GdkEventKey* event);
     bool _on_window_configure_event(GdkEventConfigure* configure_event);
 
+    void _autosave_tick();
+    bool _mod_time_sentinel_check();
+    void _on_mod_time_sentinel_file_changed(const Glib::RefPtr<Gio::File>& file,
+                                            const Glib::RefPtr<Gio::File>& other_file,
+                                            Gio::FileMonitorEvent event_type);
+
     void _on_treeview_cursor_changed(); // pygtk: on_node_changed
     bool _on_treeview_button_release_event(GdkEventButton* event);
     void _on_treeview_event_after(GdkEvent* event); // pygtk: on_event_after_tree
@@ -303,10 +309,18 @@ private:
     Glib::RefPtr<Gtk::CssProvider> _css_provider_theme;
 
 private:
+    // the autosave waits for a pause in the typing once due, longer if many nodes are to be written,
+    // but no more than AUTOSAVE_MAX_DELAY_S past the configured interval
+    const inline static gint64 AUTOSAVE_IDLE_S{5};
+    const inline static gint64 AUTOSAVE_IDLE_FEW_NODES_S{2};
+    const inline static size_t AUTOSAVE_FEW_NODES{4u};
+    const inline static gint64 AUTOSAVE_MAX_DELAY_S{120};
+
     bool                _userActive{true}; // pygtk: user_active
     bool                _forceExit{false};
     int                 _cursorKeyPress{-1};
-    int                 _autoSaveCounter{0};
+    gint64              _autosaveDirtySinceUs{0}; // monotonic time the unsaved changes were first seen, 0 if none
+    gint64              _lastUserInputUs{0};      // monotonic time of the latest key press or edit
     int                 _hovering_link_iter_offset{-1};
     int                 _prevTextviewWidth{0};
     bool                _fileSaveNeeded{false}; // pygtk: file_update
@@ -315,7 +329,9 @@ private:
     int                 _savedXpos{-1};
     int                 _savedYpos{-1};
     sigc::connection    _autosave_timout_connection;
-    sigc::connection    _mod_time_sentinel_timout_connection;
+    sigc::connection    _mod_time_sentinel_timout_connection; // polling, if the document cannot be monitored
+    sigc::connection    _mod_time_sentinel_check_connection;  // check shortly after a change is notified
+    Glib::RefPtr<Gio::FileMonitor> _rModTimeSentinelMonitor;
     bool                _tree_just_auto_expanded{false};
     std::unordered_map<gint64, int> _nodesCursorPos;
     std::unordered_map<gint64, int> _nodesVScrollPos;
@@ -342,4 +358,5 @@ public:
 
 private:
     void _on_dispatcher_error_msg();
+    void _on_storage_save_done(const bool ok, const Glib::ustring& error);
 };
@@ -472,17 +472,7 @@ void CtMainWin::load_buffer_from_state(std::shared_ptr<CtNodeState> state, CtTre
     }
     tree_iter.remove_all_embedded_widgets();
     std::list<CtAnchoredWidget*> widgets;
-    for (xmlpp::Node* text_node : state->buffer_xml.get_root_node()->get_children()) {
-        CtStorageXmlHelper{this}.get_text_buffer_one_slot_from_xml(gsv_buffer, text_node, widgets, nullptr, -1, "");
-    }
-
-    // xml storage doesn't have widgets, so load them separately
-    for (auto widgetState : state->widgetStates) {
-        widgets.push_back(widgetState->to_widget(this));
-    }
-    for (auto widget : widgets) {
-        widget->insertInTextBuffer(gsv_buffer);
-    }
+    state->buffer_blob.decode(this, gsv_buffer, widgets);
     get_tree_store().addAnchoredWidgets(tree_iter, widgets, &_ctTextview);
 
     text_buffer->end_not_undoable_action();
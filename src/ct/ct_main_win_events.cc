@@ -94,6 +94,7 @@ bool CtMainWin::_on_treeview_button_release_event(GdkEventButton* event)
 
 bool CtMainWin::_on_window_key_press_event(GdkEventKey* event)
 {
+    _lastUserInputUs = g_get_monotonic_time(); // the autosave waits for a pause
     if (event->state & GDK_CONTROL_MASK) {
         if (GDK_KEY_Tab == event->keyval or GDK_KEY_ISO_Left_Tab == event->keyval) {
             _uCtActions->toggle_focus_tree_text();
@@ -94,6 +94,7 @@ void CtMainWin::update_window_save_needed(const CtSaveNeededUpdType update_type,
     if (treeIter.get_node_is_rich_text()) {
         treeIter.get_node_text_buffer()->set_modified(true); // support possible change inside anchored widget which doesn't toggle modified flag
     }
+    _lastUserInputUs = g_get_monotonic_time();
     if (false == _fileSaveNeeded) {
         window_title_update(true/*save_needed*/);
         _fileSaveNeeded = true;
@@ -181,6 +182,8 @@ bool CtMainWin::file_open(const fs::path& filepath, const std::string& node_to_f
     }
 
     _uCtStorage.reset(new_storage);
+    _uCtStorage->signal_save_done.connect(sigc::mem_fun(*this, &CtMainWin::_on_storage_save_done));
+    mod_time_sentinel_restart();
 
     window_title_update(false/*saveNeeded*/);
     menu_set_bookmark_menu_items();
@@ -249,6 +252,8 @@ bool CtMainWin::file_open(const fs::path& filepath, const std::string& node_to_f
 
 bool CtMainWin::file_save_ask_user()
 {
+    // a failed background save must turn into a save needed before asking
+    _uCtStorage->save_async_wait();
     if (_uCtActions->get_were_embfiles_opened()) {
         const Glib::ustring message = Glib::ustring{"<b>"} +
             _("Temporary Files were Created and Opened with External Applications.") +
@@ -281,9 +286,9 @@ bool CtMainWin::file_save_ask_user()
     return true;
 }
 
-bool CtMainWin::file_save(const bool need_vacuum)
+bool CtMainWin::file_save(const bool need_vacuum, const bool allow_async/*= false*/)
 {
-    resetAutoSaveCounter();
+    resetAutoSaveDirtySince();
     if (_uCtStorage->get_file_path().empty()) {
         return false;
     }
@@ -294,6 +299,18 @@ bool CtMainWin::file_save(const bool need_vacuum)
         return false;
     }
     Glib::ustring error;
+    if (allow_async and not need_vacuum) {
+        if (_uCtStorage->save_async(error)) {
+            // the snapshot is taken, a failure of the writing sets the save needed back
+            update_window_save_not_needed();
+            _ctStateMachine.update_state();
+            return true;
+        }
+        if (not error.empty()) {
+            CtDialogs::error_dialog(str::xml_escape(error), *this);
+            return false;
+        }
+    }
     if (_uCtStorage->save(need_vacuum, error)) {
         update_window_save_not_needed();
         _ctStateMachine.update_state();
@@ -303,11 +320,19 @@ bool CtMainWin::file_save(const bool need_vacuum)
     return false;
 }
 
+void CtMainWin::_on_storage_save_done(const bool ok, const Glib::ustring& error)
+{
+    if (not ok) {
+        update_window_save_needed();
+        CtDialogs::error_dialog(str::xml_escape(error), *this);
+    }
+}
+
 void CtMainWin::file_save_as(const std::string& new_filepath,
                              const CtDocType doc_type,
                              const Glib::ustring& password)
 {
-    resetAutoSaveCounter();
+    resetAutoSaveDirtySince();
     Glib::ustring error;
     std::unique_ptr<CtStorageControl> new_storage{
         CtStorageControl::save_as(this,
@@ -346,7 +371,7 @@ void CtMainWin::file_save_as(const std::string& new_filepath,
 
 void CtMainWin::file_autosave_restart()
 {
-    resetAutoSaveCounter();
+    resetAutoSaveDirtySince();
     const bool was_connected = not _autosave_timout_connection.empty();
     _autosave_timout_connection.disconnect();
     if (not _pCtConfig->autosaveOn) {
@@ -360,46 +385,120 @@ void CtMainWin::file_autosave_restart()
 
     spdlog::debug("autosave on {} min", _pCtConfig->autosaveMinutes);
     _autosave_timout_connection = Glib::signal_timeout().connect_seconds([this]() {
-        if (++_autoSaveCounter >= _pCtConfig->autosaveMinutes) {
-            resetAutoSaveCounter();
-            if (get_file_save_needed()) {
-                spdlog::debug("autosave needed");
-                _uCtActions->file_save();
-            }
-            else {
-                spdlog::debug("autosave no need");
-            }
-        }
-        else spdlog::debug("autosave {}/{}", _autoSaveCounter, _pCtConfig->autosaveMinutes);
+        _autosave_tick();
         return true;
-    }, 60/*1 min iter*/);
+    }, 1/*sec*/);
+}
+
+void CtMainWin::_autosave_tick()
+{
+    if (not get_file_save_needed()) {
+        resetAutoSaveDirtySince();
+        return;
+    }
+    const gint64 nowUs = g_get_monotonic_time();
+    if (0 == _autosaveDirtySinceUs) {
+        _autosaveDirtySinceUs = nowUs;
+        return;
+    }
+    const gint64 dirtyS = (nowUs - _autosaveDirtySinceUs)/G_USEC_PER_SEC;
+    const gint64 intervalS = 60*_pCtConfig->autosaveMinutes;
+    if (dirtyS < intervalS) {
+        return;
+    }
+    if (_uCtStorage->is_saving_async()) {
+        // never overlapping, the changes since the snapshot wait for the next tick
+        return;
+    }
+    // the fewer nodes to write the cheaper the save, then a shorter pause is enough
+    const CtStorageSyncPending* pSyncPending = _uCtStorage->get_storage_sync_pending();
+    const size_t pendingNodes = pSyncPending->nodes_to_write_dict.size() + pSyncPending->nodes_to_rm_set.size();
+    const gint64 idleS = (nowUs - _lastUserInputUs)/G_USEC_PER_SEC;
+    const gint64 idleNeededS = pendingNodes <= AUTOSAVE_FEW_NODES ? AUTOSAVE_IDLE_FEW_NODES_S : AUTOSAVE_IDLE_S;
+    const bool tooStale = dirtyS >= intervalS + AUTOSAVE_MAX_DELAY_S;
+    if (idleS < idleNeededS and not tooStale) {
+        return;
+    }
+    spdlog::debug("autosave needed, {} nodes pending, idle {}s, unsaved {}s", pendingNodes, idleS, dirtyS);
+    resetAutoSaveDirtySince();
+    if (_uCtStorage->get_file_path().empty() or not get_tree_store().get_iter_first()) {
+        _uCtActions->file_save();
+    }
+    else {
+        file_save(false/*need_vacuum*/, true/*allow_async*/);
+    }
 }
 
 void CtMainWin::mod_time_sentinel_restart()
 {
-    const bool was_connected = not _mod_time_sentinel_timout_connection.empty();
+    const bool was_started = not _mod_time_sentinel_timout_connection.empty() or _rModTimeSentinelMonitor;
     _mod_time_sentinel_timout_connection.disconnect();
-    if (not _pCtConfig->modTimeSentinel) {
-        if (was_connected) spdlog::debug("mod time sentinel was stopped");
+    _mod_time_sentinel_check_connection.disconnect();
+    if (_rModTimeSentinelMonitor) {
+        _rModTimeSentinelMonitor->cancel();
+        _rModTimeSentinelMonitor.reset();
+    }
+    const fs::path file_path = _uCtStorage ? _uCtStorage->get_file_path() : fs::path{};
+    if (not _pCtConfig->modTimeSentinel or file_path.empty()) {
+        if (was_started) spdlog::debug("mod time sentinel was stopped");
         return;
     }
 
+    // notified by the file monitor (inotify on linux), no periodic I/O
+    try {
+        _rModTimeSentinelMonitor = Gio::File::create_for_path(file_path.string())->monitor(Gio::FILE_MONITOR_NONE);
+        _rModTimeSentinelMonitor->signal_changed().connect(sigc::mem_fun(*this, &CtMainWin::_on_mod_time_sentinel_file_changed));
+        spdlog::debug("mod time sentinel is monitoring {}", file_path);
+        return;
+    }
+    catch (Glib::Error& error) {
+        spdlog::debug("{} cannot monitor {}: {}", __FUNCTION__, file_path, error.what());
+        _rModTimeSentinelMonitor.reset();
+    }
+
     spdlog::debug("mod time sentinel is started");
     _mod_time_sentinel_timout_connection = Glib::signal_timeout().connect_seconds([this]() {
-        if (user_active() and _uCtStorage->get_mod_time() > 0) {
-            const time_t currModTime = fs::getmtime(_uCtStorage->get_file_path());
-            if (currModTime > _uCtStorage->get_mod_time()) {
-                spdlog::debug("mod time was {} now {}", _uCtStorage->get_mod_time(), currModTime);
-                fs::path file_path = _uCtStorage->get_file_path();
-                if (file_open(file_path, ""/*node*/, ""/*anchor*/)) {
-                    _ctStatusBar.update_status(_("The Document was Reloaded After External Update to CT* File."));
-                }
-            }
-        }
+        (void)_mod_time_sentinel_check();
         return true;
     }, 5/*sec*/);
 }
 
+void CtMainWin::_on_mod_time_sentinel_file_changed(const Glib::RefPtr<Gio::File>& /*file*/,
+                                                   const Glib::RefPtr<Gio::File>& /*other_file*/,
+                                                   Gio::FileMonitorEvent event_type)
+{
+    // the document (or a file of the multifile folder) is written, replaced or removed
+    if (Gio::FILE_MONITOR_EVENT_CHANGES_DONE_HINT != event_type and
+        Gio::FILE_MONITOR_EVENT_CREATED != event_type and
+        Gio::FILE_MONITOR_EVENT_DELETED != event_type)
+    {
+        return;
+    }
+    // a burst of notifications results in a single check, repeated while the user is not active
+    _mod_time_sentinel_check_connection.disconnect();
+    _mod_time_sentinel_check_connection = Glib::signal_timeout().connect([this]() {
+        return not _mod_time_sentinel_check();
+    }, 300/*ms*/);
+}
+
+bool CtMainWin::_mod_time_sentinel_check()
+{
+    if (not user_active()) {
+        return false;
+    }
+    if (_uCtStorage->get_mod_time() > 0) {
+        const time_t currModTime = fs::getmtime(_uCtStorage->get_file_path());
+        if (currModTime > _uCtStorage->get_mod_time()) {
+            spdlog::debug("mod time was {} now {}", _uCtStorage->get_mod_time(), currModTime);
+            fs::path file_path = _uCtStorage->get_file_path();
+            if (file_open(file_path, ""/*node*/, ""/*anchor*/)) {
+                _ctStatusBar.update_status(_("The Document was Reloaded After External Update to CT* File."));
+            }
+        }
+    }
+    return true;
+}
+
 bool CtMainWin::file_insert_plain_text(const fs::path& filepath)
 {
     spdlog::debug("trying to insert text file as node: {}", filepath);
@@ -303,6 +303,8 @@ void CtMenu::init_actions(CtActions* pActions)
         _("Go to the Previous Visited Node"), sigc::mem_fun(*pActions, &CtActions::node_go_back)});
     _actions.push_back(CtMenuAction{tree_cat, "go_node_next", "ct_go-forward", _("Go _Forward"), KB_ALT+CtConst::STR_KEY_RIGHT,
         _("Go to the Next Visited Node"), sigc::mem_fun(*pActions, &CtActions::node_go_forward)});
+    _actions.push_back(CtMenuAction{tree_cat, "go_node_quick", "ct_find", _("_Go to Node..."), KB_CONTROL+KB_SHIFT+"g",
+        _("Go to a Node Searched by Name"), sigc::mem_fun(*pActions, &CtActions::node_quick_jump)});
     _actions.push_back(CtMenuAction{tree_cat, "tree_add_node", "ct_tree-node-add", _("Add _Node..."), KB_CONTROL+"n",
         _("Add a Node having the same Parent of the Selected Node"), sigc::mem_fun(*pActions, &CtActions::node_add)});
     _actions.push_back(CtMenuAction{tree_cat, "tree_add_subnode", "ct_tree-subnode-add", _("Add _Subnode..."), KB_CONTROL+KB_SHIFT+"n",
@@ -291,6 +291,7 @@ const char* CtMenu::_get_ui_str_menu()
   <menu action='TreeMenu'>
     <menuitem action='go_node_next'/>
     <menuitem action='go_node_prev'/>
+    <menuitem action='go_node_quick'/>
     <separator/>
     <menuitem action='tree_add_node'/>
     <menuitem action='tree_add_subnode'/>
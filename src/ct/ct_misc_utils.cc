@@ -26,6 +26,7 @@
 #include <pangomm.h>
 #include <iostream>
 #include <cstring>
+#include <algorithm>
 #include "ct_const.h"
 #include "ct_logging.h"
 #include "ct_list.h"
@@ -171,15 +172,19 @@ std::string CtMiscUtil::get_node_hierarchical_name(const CtTreeIter tree_iter, c
                                                    const bool for_filename/*=true*/, const bool root_to_leaf/*=true*/,
                                                    const bool trail_node_id/*=false*/, const char* trailer/*=""*/)
 {
-    std::string hierarchical_name = str::trim(tree_iter.get_node_name());
-    CtTreeIter father_iter = tree_iter.parent();
-    while (father_iter) {
-        std::string father_name = str::trim(father_iter.get_node_name());
-        if (root_to_leaf)
-            hierarchical_name = father_name + separator + hierarchical_name;
-        else
-            hierarchical_name = hierarchical_name + separator + father_name;
-        father_iter = father_iter.parent();
+    const std::vector<std::string>& names = tree_iter.get_node_hierarchical_names();
+    std::string hierarchical_name;
+    if (root_to_leaf) {
+        for (auto it = names.begin(); it != names.end(); ++it) {
+            if (it != names.begin()) hierarchical_name += separator;
+            hierarchical_name += *it;
+        }
+    }
+    else {
+        for (auto it = names.rbegin(); it != names.rend(); ++it) {
+            if (it != names.rbegin()) hierarchical_name += separator;
+            hierarchical_name += *it;
+        }
     }
     if (trail_node_id) {
         hierarchical_name += fmt::format("_{:d}", tree_iter.get_node_id());
@@ -1021,78 +1026,88 @@ Glib::ustring str::sanitize_bad_symbols(const Glib::ustring& xml_content)
     return re_pattern->replace(xml_content, 0/*start_position*/, "", static_cast<Glib::RegexMatchFlags>(0u));
 }
 
-struct DiacrToAscii {
-    DiacrToAscii(const char* replacement_, const char* pattern_)
-     : replacement{replacement_}
-     , pattern{pattern_}
-    {}
-    Glib::ustring replacement;
-    Glib::ustring pattern;
-    Glib::RefPtr<Glib::Regex> pRegExp;
-};
-static std::list<DiacrToAscii> list_DiacrToAscii{
-    {"a", "[àáâãäåāăąạ]"},
-    {"A", "[ÀÁÂÃÄÅĀĂĄẠ]"},
-    {"b", "[ḅ]"},
-    {"B", "[Ḅ]"},
-    {"c", "[çćĉċč]"},
-    {"C", "[ÇĆĈĊČ]"},
-    {"d", "[ďđḍ]"},
-    {"D", "[ĎĐḌ]"},
-    {"e", "[èéêëēĕėęěẹ]"},
-    {"E", "[ÈÉÊËĒĔĖĘĚẸ]"},
-    {"g", "[ĝğġģ]"},
-    {"G", "[ĜĞĠĢ]"},
-    {"h", "[ĥħḥ]"},
-    {"H", "[ĤĦḤ]"},
-    {"i", "[ìíîïĩīĭįıị]"},
-    {"I", "[ÌÍÎÏĨĪĬĮİỊ]"},
-    {"j", "[ĵ]"},
-    {"J", "[Ĵ]"},
-    {"k", "[ķḳ]"},
-    {"K", "[ĶḲ]"},
-    {"l", "[ĺļľŀłḷ]"},
-    {"L", "[ĹĻĽĿŁḶ]"},
-    {"m", "[ṃ]"},
-    {"M", "[Ṃ]"},
-    {"n", "[ñńņňŉṇ]"},
-    {"N", "[ÑŃŅŇṆ]"},
-    {"o", "[òóôõöøōŏőọ]"},
-    {"O", "[ÒÓÔÕÖØŌŎŐỌ]"},
-    {"r", "[ŕŗřṛ]"},
-    {"R", "[ŔŖŘṚ]"},
-    {"s", "[śŝşšṣ]"},
-    {"S", "[ŚŜŞŠṢ]"},
-    {"t", "[ţťŧṭ]"},
-    {"T", "[ŢŤŦṬ]"},
-    {"u", "[ùúûüũūŭůűųụ]"},
-    {"U", "[ÙÚÛÜŨŪŬŮŰŲỤ]"},
-    {"w", "[ŵẉ]"},
-    {"W", "[ŴẈ]"},
-    {"y", "[ýŷÿỵ]"},
-    {"Y", "[ÝŶŸỴ]"},
-    {"z", "[źżžẓ]"},
-    {"Z", "[ŹŻŽẒ]"},
+// every diacritical character is folded to a single ascii one, so the characters offsets are the same in and out
+static const std::vector<std::pair<char, const char*>> DiacrToAsciiTable{
+    {'a', "àáâãäåāăąạ"},
+    {'A', "ÀÁÂÃÄÅĀĂĄẠ"},
+    {'b', "ḅ"},
+    {'B', "Ḅ"},
+    {'c', "çćĉċč"},
+    {'C', "ÇĆĈĊČ"},
+    {'d', "ďđḍ"},
+    {'D', "ĎĐḌ"},
+    {'e', "èéêëēĕėęěẹ"},
+    {'E', "ÈÉÊËĒĔĖĘĚẸ"},
+    {'g', "ĝğġģ"},
+    {'G', "ĜĞĠĢ"},
+    {'h', "ĥħḥ"},
+    {'H', "ĤĦḤ"},
+    {'i', "ìíîïĩīĭįıị"},
+    {'I', "ÌÍÎÏĨĪĬĮİỊ"},
+    {'j', "ĵ"},
+    {'J', "Ĵ"},
+    {'k', "ķḳ"},
+    {'K', "ĶḲ"},
+    {'l', "ĺļľŀłḷ"},
+    {'L', "ĹĻĽĿŁḶ"},
+    {'m', "ṃ"},
+    {'M', "Ṃ"},
+    {'n', "ñńņňŉṇ"},
+    {'N', "ÑŃŅŇṆ"},
+    {'o', "òóôõöøōŏőọ"},
+    {'O', "ÒÓÔÕÖØŌŎŐỌ"},
+    {'r', "ŕŗřṛ"},
+    {'R', "ŔŖŘṚ"},
+    {'s', "śŝşšṣ"},
+    {'S', "ŚŜŞŠṢ"},
+    {'t', "ţťŧṭ"},
+    {'T', "ŢŤŦṬ"},
+    {'u', "ùúûüũūŭůűųụ"},
+    {'U', "ÙÚÛÜŨŪŬŮŰŲỤ"},
+    {'w', "ŵẉ"},
+    {'W', "ŴẈ"},
+    {'y', "ýŷÿỵ"},
+    {'Y', "ÝŶŸỴ"},
+    {'z', "źżžẓ"},
+    {'Z', "ŹŻŽẒ"},
 };
-static bool list_DiacrToAscii_initialised{false};
 
 // https://docs.oracle.com/cd/E29584_01/webhelp/mdex_basicDev/src/rbdv_chars_mapping.html
 Glib::ustring str::diacritical_to_ascii(const Glib::ustring& in_text)
 {
-    const Glib::RegexMatchFlags re_flags{static_cast<Glib::RegexMatchFlags>(0u)};
-    Glib::ustring tmp_str{in_text};
-    if (not list_DiacrToAscii_initialised) {
-        list_DiacrToAscii_initialised = true;
-        for (DiacrToAscii& curr_DiacrToAscii : list_DiacrToAscii) {
-            curr_DiacrToAscii.pRegExp = Glib::Regex::create(curr_DiacrToAscii.pattern);
+    // code point -> ascii, '\0' where unchanged (function local static, initialised once also with concurrent callers)
+    static const std::vector<char> foldTable = [](){
+        std::vector<char> table;
+        for (const auto& [asciiCh, diacriticals] : DiacrToAsciiTable) {
+            for (const gchar* pCh = diacriticals; *pCh; pCh = g_utf8_next_char(pCh)) {
+                const gunichar uc = g_utf8_get_char(pCh);
+                if (uc >= table.size()) table.resize(uc + 1, '\0');
+                table[uc] = asciiCh;
+            }
         }
-    }
-    for (DiacrToAscii& curr_DiacrToAscii : list_DiacrToAscii) {
-        if (curr_DiacrToAscii.pRegExp->match(tmp_str, re_flags)) {
-            tmp_str = curr_DiacrToAscii.pRegExp->replace(tmp_str, 0/*start_position*/, curr_DiacrToAscii.replacement, re_flags);
+        return table;
+    }();
+    const std::string& in_raw = in_text.raw();
+    std::string out_raw;
+    out_raw.reserve(in_raw.size());
+    const gchar* pCh = in_raw.data();
+    const gchar* const pEnd = pCh + in_raw.size();
+    while (pCh < pEnd) {
+        if (static_cast<unsigned char>(*pCh) < 0x80u) {
+            out_raw.push_back(*pCh++);
+            continue;
+        }
+        const gchar* pNext = std::min<const gchar*>(g_utf8_next_char(pCh), pEnd);
+        const gunichar uc = g_utf8_get_char(pCh);
+        if (uc < foldTable.size() and foldTable[uc]) {
+            out_raw.push_back(foldTable[uc]);
+        }
+        else {
+            out_raw.append(pCh, pNext);
         }
+        pCh = pNext;
     }
-    return tmp_str;
+    return out_raw;
 }
 
 Glib::ustring str::re_escape(const Glib::ustring& text)
@@ -1131,6 +1146,252 @@ int str::byte_pos_to_symb_pos(const Glib::ustring& text, int byte_pos)
     return (int)g_utf8_pointer_to_offset(text.data(), text.data() + byte_pos);
 }
 
+void CtUtf8Cursor::set_text(Glib::ustring text)
+{
+    _text = std::move(text);
+    _charPos = 0;
+    _bytePos = 0;
+}
+
+int CtUtf8Cursor::char_to_byte(const int charPos)
+{
+    const char* pText = _text.data();
+    const int numBytes = static_cast<int>(_text.bytes());
+    if (charPos < _charPos - charPos) {
+        // closer to the text start than to the running position
+        _charPos = 0;
+        _bytePos = 0;
+    }
+    while (_charPos < charPos and _bytePos < numBytes) {
+        _bytePos = static_cast<int>(g_utf8_next_char(pText + _bytePos) - pText);
+        ++_charPos;
+    }
+    while (_charPos > charPos and _bytePos > 0) {
+        _bytePos = static_cast<int>(g_utf8_prev_char(pText + _bytePos) - pText);
+        --_charPos;
+    }
+    return _bytePos;
+}
+
+int CtUtf8Cursor::byte_to_char(const int bytePos)
+{
+    const char* pText = _text.data();
+    if (bytePos < _bytePos - bytePos) {
+        _charPos = 0;
+        _bytePos = 0;
+    }
+    while (_bytePos < bytePos) {
+        _bytePos = static_cast<int>(g_utf8_next_char(pText + _bytePos) - pText);
+        ++_charPos;
+    }
+    while (_bytePos > bytePos) {
+        _bytePos = static_cast<int>(g_utf8_prev_char(pText + _bytePos) - pText);
+        --_charPos;
+    }
+    return _charPos;
+}
+
+void CtUtf8Cursor::replace_bytes(const int byteStart, const int byteEnd, const Glib::ustring& replacement)
+{
+    const auto itBase = _text.begin().base();
+    _text.replace(Glib::ustring::iterator{itBase + byteStart}, Glib::ustring::iterator{itBase + byteEnd}, replacement);
+    if (_bytePos > byteStart) {
+        _charPos = 0;
+        _bytePos = 0;
+    }
+}
+
+CtLiteralFinder::CtLiteralFinder(const Glib::ustring& pattern, const bool matchCase, const bool wholeWord, const bool startWord)
+ : _pattern{pattern.raw()}
+ , _matchCase{matchCase}
+ , _wholeWord{wholeWord}
+ , _startWord{startWord}
+{
+    if (_matchCase or pattern.empty()) {
+        return;
+    }
+    _patternForms = _case_forms(pattern);
+    for (const gunichar form : _patternForms.front()) {
+        _firstForms.push_back(Glib::ustring(1, form).raw());
+    }
+}
+
+bool CtLiteralFinder::find_forward(const Glib::ustring& text, const int startByte, int& matchStart, int& matchEnd) const
+{
+    size_t start, end;
+    if (not _find(text.raw(), static_cast<size_t>(startByte), start, end)) {
+        return false;
+    }
+    matchStart = static_cast<int>(start);
+    matchEnd = static_cast<int>(end);
+    return true;
+}
+
+bool CtLiteralFinder::find_backward(const Glib::ustring& text, const int endByte, int& matchStart, int& matchEnd) const
+{
+    // as the regex, the matches do not overlap and are searched from the text start
+    const std::string_view textView{text.data(), static_cast<size_t>(endByte)};
+    bool found{false};
+    size_t from{0}, start, end;
+    while (_find(textView, from, start, end)) {
+        found = true;
+        matchStart = static_cast<int>(start);
+        matchEnd = static_cast<int>(end);
+        from = end;
+    }
+    return found;
+}
+
+bool CtLiteralFinder::match(std::string_view text) const
+{
+    size_t start, end;
+    return _find(text, 0, start, end);
+}
+
+bool CtLiteralFinder::_find(std::string_view text, size_t from, size_t& matchStart, size_t& matchEnd) const
+{
+    if (_pattern.empty()) {
+        return false;
+    }
+    if (_matchCase) {
+        for (size_t pos = text.find(_pattern, from); pos != std::string_view::npos; pos = text.find(_pattern, pos + 1)) {
+            if (_boundaries_ok(text, pos, pos + _pattern.size())) {
+                matchStart = pos;
+                matchEnd = pos + _pattern.size();
+                return true;
+            }
+        }
+        return false;
+    }
+    // next occurrence of each form of the first character, searched again only once passed
+    std::vector<size_t> formsNextPos;
+    for (const std::string& form : _firstForms) {
+        formsNextPos.push_back(text.find(form, from));
+    }
+    while (true) {
+        const size_t pos = *std::min_element(formsNextPos.begin(), formsNextPos.end());
+        if (std::string_view::npos == pos) {
+            return false;
+        }
+        size_t end;
+        if (_caseless_match_at(text, pos, end) and _boundaries_ok(text, pos, end)) {
+            matchStart = pos;
+            matchEnd = end;
+            return true;
+        }
+        from = pos + 1;
+        for (size_t i = 0; i < _firstForms.size(); ++i) {
+            if (formsNextPos[i] < from) {
+                formsNextPos[i] = text.find(_firstForms[i], from);
+            }
+        }
+    }
+}
+
+bool CtLiteralFinder::_caseless_match_at(std::string_view text, const size_t pos, size_t& matchEnd) const
+{
+    const gchar* pCh = text.data() + pos;
+    const gchar* const pEnd = text.data() + text.size();
+    for (const std::vector<gunichar>& forms : _patternForms) {
+        if (pCh >= pEnd or not vec::exists(forms, g_utf8_get_char(pCh))) {
+            return false;
+        }
+        pCh = g_utf8_next_char(pCh);
+    }
+    if (pCh > pEnd) {
+        return false;
+    }
+    matchEnd = static_cast<size_t>(pCh - text.data());
+    return true;
+}
+
+bool CtLiteralFinder::_boundaries_ok(std::string_view text, const size_t matchStart, const size_t matchEnd) const
+{
+    if (_wholeWord) {
+        return _is_word_boundary(text, matchStart) and _is_word_boundary(text, matchEnd);
+    }
+    if (_startWord) {
+        return _is_word_boundary(text, matchStart);
+    }
+    return true;
+}
+
+/*static*/bool CtLiteralFinder::_is_word_boundary(std::string_view text, const size_t pos)
+{
+    // \w of Glib::Regex, which enables the unicode properties
+    auto is_word_char = [](const gunichar uc){ return g_unichar_isalnum(uc) or '_' == uc; };
+    const bool wordBefore = pos > 0 and is_word_char(g_utf8_get_char(g_utf8_prev_char(text.data() + pos)));
+    const bool wordAfter = pos < text.size() and is_word_char(g_utf8_get_char(text.data() + pos));
+    return wordBefore != wordAfter;
+}
+
+/*static*/std::vector<std::vector<gunichar>> CtLiteralFinder::_case_forms(const Glib::ustring& pattern)
+{
+    // the caseless regex matches the characters with the same simple case folding, which is more than
+    // lower/upper/title case (KELVIN SIGN for k, final sigma for sigma) and less (not U+0130 for i)
+    auto f_fold_key = [](const gunichar ch)->gunichar{
+        g_autofree gchar* pFolded = g_utf8_casefold(Glib::ustring(1, ch).c_str(), -1);
+        if (1 == g_utf8_strlen(pFolded, -1)) {
+            return g_utf8_get_char(pFolded);
+        }
+        // full folding to several characters: the simple one is the lowercase if that has the same full folding
+        const gunichar lower = g_unichar_tolower(ch);
+        g_autofree gchar* pLowerFolded = g_utf8_casefold(Glib::ustring(1, lower).c_str(), -1);
+        return 0 == g_strcmp0(pFolded, pLowerFolded) ? lower : ch;
+    };
+    auto f_is_cased = [](const gunichar ch){
+        return g_unichar_tolower(ch) != ch or g_unichar_toupper(ch) != ch or g_unichar_istitle(ch);
+    };
+    // the characters sharing a folding also share the lowercase or the uppercase of either the pattern
+    // character or its folding (KELVIN SIGN lowercase k, final sigma uppercase SIGMA), so the code points
+    // scan only runs table lookups and folds the few candidates
+    struct CtCaseClass {
+        gunichar key;
+        gunichar lowers[2];
+        gunichar uppers[2];
+        std::vector<gunichar> forms;
+    };
+    std::vector<CtCaseClass> caseClasses; // of the distinct cased pattern characters
+    std::vector<int> charClasses; // index in caseClasses of each pattern character, -1 if not cased
+    for (const gunichar uc : pattern) {
+        if (not f_is_cased(uc)) {
+            charClasses.push_back(-1);
+            continue;
+        }
+        const gunichar key = f_fold_key(uc);
+        auto it = std::find_if(caseClasses.begin(), caseClasses.end(), [key](const CtCaseClass& caseClass){ return key == caseClass.key; });
+        if (caseClasses.end() == it) {
+            caseClasses.push_back(CtCaseClass{key,
+                                              {g_unichar_tolower(uc), g_unichar_tolower(key)},
+                                              {g_unichar_toupper(uc), g_unichar_toupper(key)},
+                                              {}});
+            it = std::prev(caseClasses.end());
+        }
+        charClasses.push_back(static_cast<int>(it - caseClasses.begin()));
+    }
+    if (not caseClasses.empty()) {
+        for (gunichar ch = 0; ch < 0x20000; ++ch) {
+            const gunichar lower = g_unichar_tolower(ch);
+            const gunichar upper = g_unichar_toupper(ch);
+            for (CtCaseClass& caseClass : caseClasses) {
+                if ((lower == caseClass.lowers[0] or lower == caseClass.lowers[1] or
+                     upper == caseClass.uppers[0] or upper == caseClass.uppers[1]) and
+                    g_unichar_validate(ch) and f_is_cased(ch) and caseClass.key == f_fold_key(ch))
+                {
+                    caseClass.forms.push_back(ch);
+                }
+            }
+        }
+    }
+    std::vector<std::vector<gunichar>> patternForms;
+    auto itChar = pattern.begin();
+    for (const int classIdx : charClasses) {
+        patternForms.push_back(classIdx < 0 ? std::vector<gunichar>{*itChar} : caseClasses[classIdx].forms);
+        ++itChar;
+    }
+    return patternForms;
+}
+
 Glib::ustring str::swapcase(const Glib::ustring& text)
 {
     Glib::ustring ret_text;
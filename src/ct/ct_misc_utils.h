@@ -28,6 +28,7 @@
 #include <gtksourceviewmm.h>
 #include <gtkmm/treeiter.h>
 #include <gtkmm/treestore.h>
+#include <string_view>
 
 class CtConfig;
 class CtTreeIter;
@@ -475,3 +476,53 @@ bool exists(const MAP& m, const KEY& key)
 }
 
 } // namespace map
+
+// UTF-8 text with a running character/byte position pair, so that a conversion
+// costs the distance from the previous one instead of a walk from the text start
+class CtUtf8Cursor
+{
+public:
+    void set_text(Glib::ustring text);
+    const Glib::ustring& get_text() const { return _text; }
+
+    int char_to_byte(const int charPos);
+    int byte_to_char(const int bytePos);
+    // replace the bytes byteStart..byteEnd keeping the running position if before byteStart
+    void replace_bytes(const int byteStart, const int byteEnd, const Glib::ustring& replacement);
+
+private:
+    Glib::ustring _text;
+    int _charPos{0};
+    int _bytePos{0};
+};
+
+// Search of a non empty literal pattern with the same matches as the escaped pattern compiled in a Glib::Regex:
+// plain substring search when case sensitive, else search of the first pattern character forms
+// then caseless comparison of the rest, the forms of a character being those sharing its simple
+// case folding as in the regex engine; \b word boundaries checked at the match ends
+class CtLiteralFinder
+{
+public:
+    CtLiteralFinder(const Glib::ustring& pattern, const bool matchCase, const bool wholeWord, const bool startWord);
+
+    // first match starting at or after startByte, byte offsets
+    bool find_forward(const Glib::ustring& text, const int startByte, int& matchStart, int& matchEnd) const;
+    // last match in the text truncated at endByte, byte offsets
+    bool find_backward(const Glib::ustring& text, const int endByte, int& matchStart, int& matchEnd) const;
+    bool match(const Glib::ustring& text) const { return match(std::string_view{text.raw()}); }
+    bool match(std::string_view text) const;
+
+private:
+    bool _find(std::string_view text, size_t from, size_t& matchStart, size_t& matchEnd) const;
+    bool _caseless_match_at(std::string_view text, const size_t pos, size_t& matchEnd) const;
+    bool _boundaries_ok(std::string_view text, const size_t matchStart, const size_t matchEnd) const;
+    static bool _is_word_boundary(std::string_view text, const size_t pos);
+    static std::vector<std::vector<gunichar>> _case_forms(const Glib::ustring& pattern);
+
+    const std::string _pattern;
+    const bool _matchCase;
+    const bool _wholeWord;
+    const bool _startWord;
+    std::vector<std::vector<gunichar>> _patternForms; // caseless only, case forms of each pattern character
+    std::vector<std::string> _firstForms; // caseless only, utf-8 forms of the first pattern character
+};
@@ -31,6 +31,7 @@
 #include <thread>
 
 extern int p7za_exec(int numArgs, char *args[]);
+extern int p7za_archive_mem(const void* data, size_t size, const char* itemName, const char* outputPath, const char* passwd, unsigned numThreads);
 extern void cherrytree_register_7zaes();
 extern void cherrytree_register_crc32();
 extern void cherrytree_register_crc_table();
@@ -76,10 +77,16 @@ int CtP7zaIface::p7za_extract(const gchar* input_path, const gchar* out_dir, con
     return ret_val;
 }
 
-int CtP7zaIface::p7za_archive(const gchar* input_path, const gchar* output_path, const gchar* passwd)
+static size_t get_concur_num()
 {
     size_t concur_num = std::thread::hardware_concurrency();
     if (concur_num == 0) concur_num = 4;
+    return concur_num;
+}
+
+int CtP7zaIface::p7za_archive(const gchar* input_path, const gchar* output_path, const gchar* passwd)
+{
+    const size_t concur_num = get_concur_num();
 
     g_autofree gchar* p_workspace_dir = g_path_get_dirname(output_path);
     // https://stackoverflow.com/questions/39914398/7zip-fastest-lzma2-compression
@@ -108,3 +115,14 @@ int CtP7zaIface::p7za_archive(const gchar* input_path, const gchar* output_path,
     g_strfreev(pp_args);
     return ret_val;
 }
+
+int CtP7zaIface::p7za_archive_from_memory(const void* data,
+                                          const size_t size,
+                                          const gchar* item_name,
+                                          const gchar* output_path,
+                                          const gchar* passwd)
+{
+    // same compression settings as p7za_archive, the 7z handler driven directly
+    register_codecs();
+    return p7za_archive_mem(data, size, item_name, output_path, passwd, (unsigned)get_concur_num());
+}
@@ -22,6 +22,7 @@
 #pragma once
 #include <glib.h>
 #include <glib/gtypes.h>
+#include <cstddef>
 
 namespace CtP7zaIface {
 
@@ -29,5 +30,12 @@ int p7za_extract(const gchar* input_path, const gchar* out_dir, const gchar* pas
 
 int p7za_archive(const gchar* input_path, const gchar* output_path, const gchar* passwd);
 
+// archives in process the buffer as the single item item_name, no file read
+int p7za_archive_from_memory(const void* data,
+                             const size_t size,
+                             const gchar* item_name,
+                             const gchar* output_path,
+                             const gchar* passwd);
+
 } // namespace CtP7zaIface
 
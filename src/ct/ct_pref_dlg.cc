@@ -253,6 +253,14 @@ Gtk::Widget* CtPrefDlg::build_tab_interface()
     hbox_find_all_max_in_page->pack_start(*label_find_all_max_in_page, false, false);
     hbox_find_all_max_in_page->pack_start(*spinbutton_find_all_max_in_page, false, false);
 
+    auto hbox_find_all_max_in_search = Gtk::manage(new Gtk::Box{Gtk::ORIENTATION_HORIZONTAL, 4/*spacing*/});
+    auto label_find_all_max_in_search = Gtk::manage(new Gtk::Label{_("Max Search Results (0 = No Limit)")});
+    label_find_all_max_in_search->set_margin_left(2);
+    Glib::RefPtr<Gtk::Adjustment> adjustment_find_all_max_in_search = Gtk::Adjustment::create(_pConfig->maxMatchesInSearch, 0, 1000000, 1);
+    auto spinbutton_find_all_max_in_search = Gtk::manage(new Gtk::SpinButton{adjustment_find_all_max_in_search});
+    hbox_find_all_max_in_search->pack_start(*label_find_all_max_in_search, false, false);
+    hbox_find_all_max_in_search->pack_start(*spinbutton_find_all_max_in_search, false, false);
+
     vbox_misc->pack_start(*checkbutton_word_count, false, false);
     vbox_misc->pack_start(*checkbutton_win_title_doc_dir, false, false);
     vbox_misc->pack_start(*checkbutton_nn_header_full_path, false, false);
@@ -263,6 +271,7 @@ Gtk::Widget* CtPrefDlg::build_tab_interface()
     vbox_misc->pack_start(*hbox_scrollbar_overlay, false, false);
     vbox_misc->pack_start(*hbox_tooltips_enable, false, false);
     vbox_misc->pack_start(*hbox_find_all_max_in_page, false, false);
+    vbox_misc->pack_start(*hbox_find_all_max_in_search, false, false);
 
     Gtk::Frame* frame_misc = new_managed_frame_with_align(_("Miscellaneous"), vbox_misc);
 
@@ -402,6 +411,9 @@ Gtk::Widget* CtPrefDlg::build_tab_interface()
         _pConfig->maxMatchesInPage = spinbutton_find_all_max_in_page->get_value_as_int();
         _pCtMainWin->get_ct_actions()->find_matches_store_reset();
     });
+    spinbutton_find_all_max_in_search->signal_value_changed().connect([this, spinbutton_find_all_max_in_search](){
+        _pConfig->maxMatchesInSearch = spinbutton_find_all_max_in_search->get_value_as_int();
+    });
 
     return pMainBox;
 }
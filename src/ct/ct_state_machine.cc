@@ -23,7 +23,6 @@
 
 #include "ct_state_machine.h"
 #include "ct_main_win.h"
-#include "ct_storage_xml.h"
 
 // ImagePng
 CtAnchoredWidgetState_ImagePng::CtAnchoredWidgetState_ImagePng(CtImagePng* image)
@@ -283,12 +282,7 @@ void CtStateMachine::node_selected_changed(const gint64 node_id_data_holder)
     if (not map::exists(_node_states, node_id_data_holder)) {
         CtTreeIter node = _pCtMainWin->curr_tree_iter();
         auto state = std::shared_ptr<CtNodeState>(new CtNodeState{});
-        CtStorageXmlHelper{_pCtMainWin}.save_buffer_no_widgets_to_xml(state->buffer_xml.get_root_node(),
-                                                                      node.get_node_text_buffer(), 0, -1, 'n');
-        state->buffer_xml_string = state->buffer_xml.write_to_string();
-        for (auto widget : node.get_anchored_widgets()) {
-            state->widgetStates.push_back(widget->get_state());
-        }
+        state->buffer_blob.encode(_pCtMainWin->get_ct_config(), node.get_node_text_buffer(), node.get_anchored_widgets());
 
         CtNodeStates states;
         states.states.push_back(state);
@@ -404,24 +398,11 @@ void CtStateMachine::update_state(CtTreeIter tree_iter)
     }
 
     auto new_state = std::shared_ptr<CtNodeState>(new CtNodeState{});
-    CtStorageXmlHelper{_pCtMainWin}.save_buffer_no_widgets_to_xml(new_state->buffer_xml.get_root_node(),
-                                                                  tree_iter.get_node_text_buffer(), 0, -1, 'n');
-    new_state->buffer_xml_string = new_state->buffer_xml.write_to_string();
-    for (auto widget : tree_iter.get_anchored_widgets()) {
-        new_state->widgetStates.push_back(widget->get_state());
-    }
+    new_state->buffer_blob.encode(_pCtMainWin->get_ct_config(), tree_iter.get_node_text_buffer(), tree_iter.get_anchored_widgets());
 
     if (node_states.states.size() > 0) {
-        auto compare_widgets = [](const std::list<std::shared_ptr<CtAnchoredWidgetState>> lhs,
-                                  const std::list<std::shared_ptr<CtAnchoredWidgetState>> rhs){
-            return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](std::shared_ptr<CtAnchoredWidgetState> lhs, std::shared_ptr<CtAnchoredWidgetState> rhs) {
-                return lhs->equal(rhs);
-            });
-        };
         auto last_state = node_states.states.back();
-        if (new_state->buffer_xml_string == last_state->buffer_xml_string and
-            compare_widgets(new_state->widgetStates, last_state->widgetStates))
-        {
+        if (new_state->buffer_blob == last_state->buffer_blob) {
             return; // #print "update_state not needed"
         }
     }
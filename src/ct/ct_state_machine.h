@@ -27,6 +27,7 @@
 #include "ct_image.h"
 #include "ct_codebox.h"
 #include "ct_table.h"
+#include "ct_buffer_blob.h"
 #include <vector>
 #include <map>
 #include <glibmm/regex.h>
@@ -158,11 +159,7 @@ public:
 
 struct CtNodeState
 {
-    CtNodeState()  { buffer_xml.create_root_node("buffer"); }
-
-    std::list<std::shared_ptr<CtAnchoredWidgetState>> widgetStates;
-    xmlpp::Document buffer_xml;
-    Glib::ustring   buffer_xml_string;
+    CtBufferBlob    buffer_blob;
     int             cursor_pos{0};
     int             v_adj_val{0};
 };
@@ -26,10 +26,12 @@
 #include "ct_storage_xml.h"
 #include "ct_storage_sqlite.h"
 #include "ct_storage_multifile.h"
+#include "ct_storage_stats.h"
 #include "ct_p7za_iface.h"
 #include "ct_main_win.h"
 #include "ct_logging.h"
 #include <glib/gstdio.h>
+#include <gio/gio.h>
 
 //#define DEBUG_BACKUP_ENCRYPT
 
@@ -62,6 +64,8 @@
     fs::path extracted_file_path{file_path};
 
     try {
+        std::unique_ptr<CtStorageControl> doc{new CtStorageControl{pCtMainWin}};
+        doc->_statsRecorder.begin(CtStorageStatsRecorder::Op::Load, _get_backend_name(doc_type));
         if (CtDocType::MultiFile == doc_type) {
             if (not fs::is_directory(file_path)) throw std::runtime_error("no dir");
         }
@@ -70,6 +74,7 @@
 
             // unpack file if need
             if (fs::get_doc_encrypt_from_file_ext(file_path) == CtDocEncrypt::True) {
+                CtStorageStatsRecorder::Span span{&doc->_statsRecorder, CtStorageStatsRecorder::Op::Load, "extract"};
                 extracted_file_path = _extract_file(pCtMainWin, file_path, password);
                 if (extracted_file_path.empty()) {
                     // user canceled operation
@@ -82,17 +87,27 @@
         std::unique_ptr<CtStorageEntity> pStorage = CtStorageControl::_get_entity_by_type(pCtMainWin, doc_type);
         if (not pStorage) throw std::runtime_error("no storage");
 
+        pStorage->set_stats_recorder(&doc->_statsRecorder);
+
         // load from file
-        if (not pStorage->populate_treestore(extracted_file_path, error)) throw std::runtime_error(error);
+        {
+            CtStorageStatsRecorder::Span span{&doc->_statsRecorder, CtStorageStatsRecorder::Op::Load, "populate"};
+            if (not pStorage->populate_treestore(extracted_file_path, error)) throw std::runtime_error(error);
+        }
+        size_t num_nodes{0};
+        pCtMainWin->get_tree_store().get_store()->foreach_iter([&num_nodes](const Gtk::TreeIter&){
+            ++num_nodes;
+            return false; /* false for continue */
+        });
+        doc->_statsRecorder.add_nodes(CtStorageStatsRecorder::Op::Load, num_nodes);
 
         // it's ready
-        CtStorageControl* doc = new CtStorageControl{pCtMainWin};
         doc->_file_path = file_path;
         doc->_mod_time = fs::getmtime(file_path);
         doc->_password = password;
         doc->_extracted_file_path = extracted_file_path;
         doc->_storage.swap(pStorage);
-        return doc;
+        return doc.release();
     }
     catch (std::exception& e) {
         if (extracted_file_path != file_path and fs::is_regular_file(extracted_file_path)) {
@@ -213,6 +228,7 @@
         doc->_password = password;
         doc->_extracted_file_path = extracted_file_path;
         doc->_storage.swap(storage);
+        doc->_storage->set_stats_recorder(&doc->_statsRecorder);
         return doc;
     }
     catch (std::exception& e) {
@@ -259,6 +275,9 @@ bool CtStorageControl::try_reopen(Glib::ustring& error)
 
 bool CtStorageControl::save(bool need_vacuum, Glib::ustring &error)
 {
+    // a background save must be over before writing again
+    save_async_wait();
+
     _mod_time = 0;
     auto on_scope_exit = scope_guard([&](void*) {
         _pCtMainWin->get_status_bar().pop();
@@ -277,70 +296,60 @@ bool CtStorageControl::save(bool need_vacuum, Glib::ustring &error)
     main_backup += (str_timestamp + _file_path.extension());
     const CtDocType doc_type = fs::is_directory(_file_path) ? CtDocType::MultiFile : fs::get_doc_type_from_file_ext(_file_path);
     // CtDocType::MultiFile backups are elsewhere, at node (folder) level rather than whole tree level (file)
-    const bool need_main_backup = CtDocType::MultiFile != doc_type and _pCtConfig->backupCopy and _pCtConfig->backupNum > 0;
+    bool need_main_backup = CtDocType::MultiFile != doc_type and _pCtConfig->backupCopy and _pCtConfig->backupNum > 0;
     const bool need_encrypt = _file_path != _extracted_file_path;
+    // the backup is a copy rather than the moved file only for unencrypted SQLite, then it can be skipped
+    const bool backup_is_copy = need_main_backup and CtDocType::SQLite == doc_type and not need_encrypt;
+    _statsRecorder.begin(CtStorageStatsRecorder::Op::Save, _get_backend_name(doc_type));
     try {
         if (_file_path.empty()) {
             throw std::runtime_error("storage not initialized");
         }
+        const CtFileStamp stamp_before = backup_is_copy ? _get_file_stamp(_file_path) : CtFileStamp{};
 
         // sqlite could lose connection
         _storage->test_connection();
+        _storage->set_keep_written_data(need_encrypt);
 
+        if (backup_is_copy and stamp_before.mtime_usec != 0 and stamp_before == _lastBackupStamp) {
+            // the latest backup already holds this document
+            spdlog::debug("{} unchanged since the latest backup", _file_path.string());
+            need_main_backup = false;
+        }
+        if (need_main_backup and need_encrypt and not fs::exists(_file_path)) {
+            // the archive of a previous save is still to be written, its queued job holds the main backup
+            need_main_backup = false;
+        }
         if (need_main_backup) {
-            if (CtDocType::SQLite == doc_type and not need_encrypt) {
-                _storage->close_connect(); // temporary, because of sqlite keepig the file
-                if (not fs::copy_file(_file_path, main_backup)) {
-                    throw std::runtime_error(str::format(_("You Have No Write Access to %s"), _file_path.parent_path().string()));
-                }
-#if defined(DEBUG_BACKUP_ENCRYPT)
-                spdlog::debug("{} ++ {}", _file_path.string(), main_backup.string());
-#endif // DEBUG_BACKUP_ENCRYPT
-                _storage->reopen_connect();
-            }
-            else {
-                if (not fs::move_file(_file_path, main_backup)) {
-                    throw std::runtime_error(str::format(_("You Have No Write Access to %s"), _file_path.parent_path().string()));
-                }
-#if defined(DEBUG_BACKUP_ENCRYPT)
-                spdlog::debug("{} -> {}", _file_path.string(), main_backup.string());
-#endif // DEBUG_BACKUP_ENCRYPT
-            }
+            CtStorageStatsRecorder::Span span{&_statsRecorder, CtStorageStatsRecorder::Op::Save, "backup"};
+            _main_backup_make(main_backup, doc_type, need_encrypt);
         }
+        const bool has_changes = _syncPending.fix_db_tables or
+                                 _syncPending.bookmarks_to_write or
+                                 not _syncPending.nodes_to_rm_set.empty() or
+                                 not _syncPending.nodes_to_write_dict.empty();
         // save changes
-        if (not _storage->save_treestore(_extracted_file_path,
-                                         _syncPending,
-                                         error,
-                                         CtExporting::NONESAVE))
         {
-            throw std::runtime_error(error);
+            CtStorageStatsRecorder::Span span{&_statsRecorder, CtStorageStatsRecorder::Op::Save, "write"};
+            if (not _storage->save_treestore(_extracted_file_path,
+                                             _syncPending,
+                                             error,
+                                             CtExporting::NONESAVE))
+            {
+                throw std::runtime_error(error);
+            }
         }
 #if defined(DEBUG_BACKUP_ENCRYPT)
         spdlog::debug("saved {}", _extracted_file_path.string());
 #endif // DEBUG_BACKUP_ENCRYPT
         if (need_vacuum) {
+            CtStorageStatsRecorder::Span span{&_statsRecorder, CtStorageStatsRecorder::Op::Save, "vacuum"};
             _storage->vacuum();
         }
-        if (need_main_backup or need_encrypt) {
-            std::shared_ptr<CtBackupEncryptData> pBackupEncryptData = std::make_shared<CtBackupEncryptData>();
-            pBackupEncryptData->backupType = need_main_backup ? CtBackupType::SingleFile : CtBackupType::None;
-            pBackupEncryptData->needEncrypt = need_encrypt;
-            pBackupEncryptData->file_path = _file_path.string();
-            pBackupEncryptData->main_backup = main_backup.string();
-            if (need_encrypt) {
-                pBackupEncryptData->extracted_copy = _extracted_file_path.string() + (str_timestamp + _extracted_file_path.extension());
-                _storage->close_connect(); // temporary, because of sqlite keepig the file
-                if (not fs::copy_file(_extracted_file_path, pBackupEncryptData->extracted_copy)) {
-                    throw std::runtime_error(str::format(_("You Have No Write Access to %s"), _extracted_file_path.parent_path().string()));
-                }
-#if defined(DEBUG_BACKUP_ENCRYPT)
-                spdlog::debug("{} ++ {}", _extracted_file_path.string(), pBackupEncryptData->extracted_copy);
-#endif // DEBUG_BACKUP_ENCRYPT
-                _storage->reopen_connect();
-                pBackupEncryptData->password = _password;
-            }
-            backupEncryptDEQueue.push_back(pBackupEncryptData);
-        }
+        // unless this save changed the document, the latest backup matches the file as it is now
+        _lastBackupStamp = backup_is_copy and not has_changes and not need_vacuum ? _get_file_stamp(_file_path) : CtFileStamp{};
+        _stats_bytes_written_update();
+        _backup_encrypt_enqueue(str_timestamp, main_backup, need_main_backup, need_encrypt);
         _syncPending.fix_db_tables = false;
         _syncPending.bookmarks_to_write = false;
         _syncPending.nodes_to_rm_set.clear();
@@ -350,17 +359,359 @@ bool CtStorageControl::save(bool need_vacuum, Glib::ustring &error)
     }
     catch (std::exception& e) {
         // recover from backup
-        try {
-            _storage->close_connect();
-            if (need_main_backup and fs::is_regular_file(main_backup)) fs::move_file(main_backup, _file_path);
-            _storage->reopen_connect();
-        }
-        catch (std::exception& e2) { spdlog::error(e2.what()); }
+        _main_backup_restore(main_backup, need_main_backup);
+
+        spdlog::error(e.what());
+        error = e.what();
+        return false;
+    }
+}
+
+bool CtStorageControl::save_async(Glib::ustring& error)
+{
+    if (_asyncSave or _file_path.empty()) {
+        return false;
+    }
+    const CtDocType doc_type = fs::is_directory(_file_path) ? CtDocType::MultiFile : fs::get_doc_type_from_file_ext(_file_path);
+    _statsRecorder.begin(CtStorageStatsRecorder::Op::Save, _get_backend_name(doc_type));
 
+    // GTK thread phase: the snapshot of the tree, from here on independent of further edits
+    std::function<bool(Glib::ustring&)> f_write;
+    {
+        CtStorageStatsRecorder::Span span{&_statsRecorder, CtStorageStatsRecorder::Op::Save, "snapshot"};
+        _storage->set_keep_written_data(_file_path != _extracted_file_path);
+        f_write = _storage->save_treestore_snapshot(_extracted_file_path, error);
+    }
+    if (not f_write) {
+        if (not error.empty()) spdlog::error(error);
+        return false; // with an empty error the storage has no snapshot, to be saved synchronously
+    }
+    auto pAsyncSave = std::make_unique<CtAsyncSave>();
+    pAsyncSave->str_timestamp = std::to_string(g_get_monotonic_time());
+    pAsyncSave->main_backup = _file_path;
+    pAsyncSave->main_backup += (pAsyncSave->str_timestamp + _file_path.extension());
+    pAsyncSave->need_main_backup = CtDocType::MultiFile != doc_type and _pCtConfig->backupCopy and _pCtConfig->backupNum > 0;
+    pAsyncSave->need_encrypt = _file_path != _extracted_file_path;
+    if (pAsyncSave->need_main_backup and pAsyncSave->need_encrypt and not fs::exists(_file_path)) {
+        // the archive of a previous save is still to be written, its queued job holds the main backup
+        pAsyncSave->need_main_backup = false;
+    }
+    try {
+        if (pAsyncSave->need_main_backup) {
+            CtStorageStatsRecorder::Span span{&_statsRecorder, CtStorageStatsRecorder::Op::Save, "backup"};
+            _main_backup_make(pAsyncSave->main_backup, doc_type, pAsyncSave->need_encrypt);
+        }
+    }
+    catch (std::exception& e) {
         spdlog::error(e.what());
         error = e.what();
         return false;
     }
+    // the pending changes are in the snapshot, they come back only at rollback
+    pAsyncSave->syncPending = std::move(_syncPending);
+    _syncPending = CtStorageSyncPending{};
+    _syncPending.fix_db_tables = false;
+
+    _mod_time = 0;
+    _pCtMainWin->get_status_bar().push(_("Writing to Disk..."));
+    CtAsyncSave* pRaw = pAsyncSave.get();
+    pAsyncSave->thread = std::thread([this, pRaw, f_write](){
+        {
+            CtStorageStatsRecorder::Span span{&_statsRecorder, CtStorageStatsRecorder::Op::Save, "write"};
+            pRaw->ok = f_write(pRaw->error);
+        }
+        pRaw->done = true;
+        _dispatcherAsyncSaveDone.emit();
+    });
+    _asyncSave = std::move(pAsyncSave);
+    return true;
+}
+
+void CtStorageControl::save_async_wait()
+{
+    if (_asyncSave) {
+        _async_save_complete(true/*emitDone*/);
+    }
+}
+
+void CtStorageControl::_async_save_complete(const bool emitDone)
+{
+    if (not _asyncSave) {
+        return; // already completed by save_async_wait
+    }
+    std::unique_ptr<CtAsyncSave> pAsyncSave = std::move(_asyncSave);
+    pAsyncSave->thread.join();
+
+    // commit point: the written document replaces the previous one, else it is put back
+    bool ok = pAsyncSave->ok;
+    Glib::ustring error = pAsyncSave->error;
+    if (ok) {
+        _stats_bytes_written_update();
+        try {
+            _backup_encrypt_enqueue(pAsyncSave->str_timestamp, pAsyncSave->main_backup, pAsyncSave->need_main_backup, pAsyncSave->need_encrypt);
+        }
+        catch (std::exception& e) {
+            ok = false;
+            error = e.what();
+        }
+    }
+    if (not ok) {
+        _main_backup_restore(pAsyncSave->main_backup, pAsyncSave->need_main_backup);
+        _sync_pending_merge_older(pAsyncSave->syncPending);
+        spdlog::error(error.raw());
+    }
+    _mod_time = fs::getmtime(_file_path);
+    if (emitDone) {
+        _pCtMainWin->get_status_bar().pop();
+        signal_save_done.emit(ok, error);
+    }
+}
+
+void CtStorageControl::_main_backup_make(const fs::path& main_backup, const CtDocType doc_type, const bool need_encrypt)
+{
+    if (CtDocType::SQLite == doc_type and not need_encrypt) {
+        // online backup through the open connection, else copy of the closed file
+        Glib::ustring backup_error;
+        if (_storage->backup_to(main_backup, backup_error)) {
+#if defined(DEBUG_BACKUP_ENCRYPT)
+            spdlog::debug("{} => {}", _file_path.string(), main_backup.string());
+#endif // DEBUG_BACKUP_ENCRYPT
+            return;
+        }
+        if (not backup_error.empty()) {
+            spdlog::warn("{} {}", __FUNCTION__, backup_error.raw());
+            (void)fs::remove(main_backup);
+        }
+        _storage->close_connect(); // temporary, because of sqlite keepig the file
+        if (not fs::clone_file(_file_path, main_backup)) {
+            throw std::runtime_error(str::format(_("You Have No Write Access to %s"), _file_path.parent_path().string()));
+        }
+#if defined(DEBUG_BACKUP_ENCRYPT)
+        spdlog::debug("{} ++ {}", _file_path.string(), main_backup.string());
+#endif // DEBUG_BACKUP_ENCRYPT
+        _storage->reopen_connect();
+    }
+    else {
+        if (not fs::move_file(_file_path, main_backup)) {
+            throw std::runtime_error(str::format(_("You Have No Write Access to %s"), _file_path.parent_path().string()));
+        }
+#if defined(DEBUG_BACKUP_ENCRYPT)
+        spdlog::debug("{} -> {}", _file_path.string(), main_backup.string());
+#endif // DEBUG_BACKUP_ENCRYPT
+    }
+}
+
+/*static*/CtStorageControl::CtFileStamp CtStorageControl::_get_file_stamp(const fs::path& file_path)
+{
+    CtFileStamp fileStamp;
+    GFile* pGFile = g_file_new_for_path(file_path.c_str());
+    GFileInfo* pGFileInfo = g_file_query_info(pGFile,
+                                              G_FILE_ATTRIBUTE_STANDARD_SIZE "," G_FILE_ATTRIBUTE_TIME_MODIFIED "," G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC,
+                                              G_FILE_QUERY_INFO_NONE,
+                                              nullptr/*cancellable*/,
+                                              nullptr/*error*/);
+    if (pGFileInfo) {
+        fileStamp.size = static_cast<guint64>(g_file_info_get_size(pGFileInfo));
+        fileStamp.mtime_usec = g_file_info_get_attribute_uint64(pGFileInfo, G_FILE_ATTRIBUTE_TIME_MODIFIED) * G_USEC_PER_SEC +
+                               g_file_info_get_attribute_uint32(pGFileInfo, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+        g_object_unref(pGFileInfo);
+    }
+    g_object_unref(pGFile);
+    return fileStamp;
+}
+
+void CtStorageControl::_main_backup_restore(const fs::path& main_backup, const bool need_main_backup)
+{
+    try {
+        _storage->close_connect();
+        if (need_main_backup and fs::is_regular_file(main_backup)) {
+            fs::move_file(main_backup, _file_path);
+            _lastBackupStamp = CtFileStamp{};
+        }
+        _storage->reopen_connect();
+    }
+    catch (std::exception& e2) { spdlog::error(e2.what()); }
+}
+
+void CtStorageControl::_backup_encrypt_enqueue(const std::string& str_timestamp,
+                                               const fs::path& main_backup,
+                                               const bool need_main_backup,
+                                               const bool need_encrypt)
+{
+    if (not need_main_backup and not need_encrypt) {
+        return;
+    }
+    std::shared_ptr<CtBackupEncryptData> pBackupEncryptData = std::make_shared<CtBackupEncryptData>();
+    pBackupEncryptData->backupType = need_main_backup ? CtBackupType::SingleFile : CtBackupType::None;
+    pBackupEncryptData->needEncrypt = need_encrypt;
+    pBackupEncryptData->file_path = _file_path.string();
+    pBackupEncryptData->main_backup = main_backup.string();
+    if (need_encrypt) {
+        pBackupEncryptData->password = _password;
+        // the archive is written straight from the document in memory, no plaintext copy on disk
+        if (_storage->get_document_data(_extracted_file_path, pBackupEncryptData->extracted_data)) {
+            pBackupEncryptData->extracted_name = _extracted_file_path.filename().string();
+            backup_encrypt_push(pBackupEncryptData);
+            return;
+        }
+        pBackupEncryptData->extracted_copy = _extracted_file_path.string() + (str_timestamp + _extracted_file_path.extension());
+        Glib::ustring backup_error;
+        if (not _storage->backup_to(pBackupEncryptData->extracted_copy, backup_error)) {
+            if (not backup_error.empty()) {
+                spdlog::warn("{} {}", __FUNCTION__, backup_error.raw());
+                (void)fs::remove(pBackupEncryptData->extracted_copy);
+            }
+            _storage->close_connect(); // temporary, because of sqlite keepig the file
+            if (not fs::clone_file(_extracted_file_path, pBackupEncryptData->extracted_copy)) {
+                throw std::runtime_error(str::format(_("You Have No Write Access to %s"), _extracted_file_path.parent_path().string()));
+            }
+            _storage->reopen_connect();
+        }
+#if defined(DEBUG_BACKUP_ENCRYPT)
+        spdlog::debug("{} ++ {}", _extracted_file_path.string(), pBackupEncryptData->extracted_copy);
+#endif // DEBUG_BACKUP_ENCRYPT
+    }
+    backup_encrypt_push(pBackupEncryptData);
+}
+
+void CtStorageControl::backup_encrypt_push(std::shared_ptr<CtBackupEncryptData> pBackupEncryptData)
+{
+    if (pBackupEncryptData and 0u == pBackupEncryptData->saveSeq) {
+        // queued during a save, its spans are recorded after the save returned
+        pBackupEncryptData->saveSeq = _statsRecorder.get_save_seq();
+    }
+    // only the newest state of an encrypted document is worth archiving, an older one still queued is dropped
+    // and its main backup (the archive as it was before) taken over if the newer job has none
+    const std::list<std::shared_ptr<CtBackupEncryptData>> superseded = backupEncryptDEQueue.push_back_coalesce(pBackupEncryptData,
+        [](const std::shared_ptr<CtBackupEncryptData>& pNewer, std::shared_ptr<CtBackupEncryptData>& pQueued)->bool{
+            if (not pNewer or not pNewer->needEncrypt or
+                not pQueued or not pQueued->needEncrypt or pQueued->file_path != pNewer->file_path)
+            {
+                return false;
+            }
+            if (CtBackupType::None == pNewer->backupType and CtBackupType::SingleFile == pQueued->backupType) {
+                pNewer->backupType = CtBackupType::SingleFile;
+                pNewer->main_backup = pQueued->main_backup;
+                pQueued->backupType = CtBackupType::None;
+            }
+            return true;
+        });
+    for (const std::shared_ptr<CtBackupEncryptData>& pSuperseded : superseded) {
+        if (not pSuperseded->extracted_copy.empty()) {
+            (void)fs::remove(pSuperseded->extracted_copy);
+        }
+        if (CtBackupType::SingleFile == pSuperseded->backupType) {
+            (void)fs::remove(pSuperseded->main_backup);
+        }
+        spdlog::debug("{} archive job superseded", pSuperseded->file_path);
+    }
+    _backupEncryptSuperseded += superseded.size();
+    _dispatcherBackupEncryptStatus.emit();
+}
+
+void CtStorageControl::_on_backup_encrypt_status()
+{
+    // the indicator is only for the archiving, the jobs of plain documents are quick
+    Gtk::Statusbar& statusBar = _pCtMainWin->get_status_bar().statusBar;
+    const guint contextId = statusBar.get_context_id("backup_encrypt");
+    statusBar.remove_all(contextId);
+    const size_t pending = backupEncryptDEQueue.size() + (_backupEncryptBusy ? 1u : 0u);
+    if (0u == pending) {
+        // drained, the next burst of saves counts from zero
+        _backupEncryptSuperseded = 0;
+        return;
+    }
+    if (_file_path != _extracted_file_path) {
+        statusBar.push(str::format(_("Encrypting... (pending %s, superseded %s)"), pending, _backupEncryptSuperseded.load()), contextId);
+    }
+}
+
+bool CtStorageControl::_saved_document_check_pass(const fs::path& file_path, const CtDocumentData* pData, Glib::ustring& error)
+{
+    // the very same file passed already, e.g. the main backup of a save checked before; the data in
+    // memory are those just written by a save, always to be checked
+    const std::string file_key = pData ? std::string{} : _get_file_key(file_path);
+    if (not file_key.empty() and vec::exists(_checkedFiles, file_key)) {
+#if defined(DEBUG_BACKUP_ENCRYPT)
+        spdlog::debug("{} integrity check cached", file_path.string());
+#endif // DEBUG_BACKUP_ENCRYPT
+        return true;
+    }
+    std::unique_ptr<CtStorageEntity> storage = CtStorageControl::_get_entity_by_type(_pCtMainWin, fs::get_doc_type_from_file_ext(file_path));
+    if (not storage) throw std::runtime_error("no storage");
+
+    storage->set_is_dry_run();
+    // structure only: sqlite quick_check and tables, xml well formed with the right root
+    const bool pass = pData ? storage->structure_check_from_memory(pData->view(), error) : storage->structure_check(file_path, error);
+    if (pass and not file_key.empty()) {
+        _checkedFiles.push_front(file_key);
+        if (_checkedFiles.size() > CtStorageControl::CHECKED_FILES_MAX) {
+            _checkedFiles.pop_back();
+        }
+    }
+    return pass;
+}
+
+/*static*/std::string CtStorageControl::_get_file_key(const fs::path& file_path)
+{
+    // size, modification time and inode: the file is not read and a moved file keeps its key
+    GFile* pFile = g_file_new_for_path(file_path.c_str());
+    GFileInfo* pFileInfo = g_file_query_info(pFile,
+                                             G_FILE_ATTRIBUTE_STANDARD_SIZE "," G_FILE_ATTRIBUTE_TIME_MODIFIED ","
+                                             G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC "," G_FILE_ATTRIBUTE_UNIX_INODE,
+                                             G_FILE_QUERY_INFO_NONE, nullptr/*cancellable*/, nullptr/*error*/);
+    g_object_unref(pFile);
+    if (not pFileInfo) {
+        return std::string{};
+    }
+    const std::string file_key = std::to_string(g_file_info_get_size(pFileInfo)) + CtConst::CHAR_COLON +
+        std::to_string(g_file_info_get_attribute_uint64(pFileInfo, G_FILE_ATTRIBUTE_TIME_MODIFIED)) + CtConst::CHAR_DOT +
+        std::to_string(g_file_info_get_attribute_uint32(pFileInfo, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC)) + CtConst::CHAR_COLON +
+        std::to_string(g_file_info_get_attribute_uint64(pFileInfo, G_FILE_ATTRIBUTE_UNIX_INODE));
+    g_object_unref(pFileInfo);
+    return file_key;
+}
+
+void CtStorageControl::_stats_bytes_written_update()
+{
+    // the multiple files are written node by node, not measured
+    if (fs::is_regular_file(_extracted_file_path)) {
+        _statsRecorder.set_bytes_written(fs::file_size(_extracted_file_path));
+    }
+}
+
+/*static*/const char* CtStorageControl::_get_backend_name(const CtDocType doc_type)
+{
+    switch (doc_type) {
+        case CtDocType::SQLite: return "sqlite";
+        case CtDocType::XML: return "xml";
+        case CtDocType::MultiFile: return "multifile";
+        default: return "none";
+    }
+}
+
+void CtStorageControl::_sync_pending_merge_older(const CtStorageSyncPending& olderPending)
+{
+    _syncPending.fix_db_tables = _syncPending.fix_db_tables or olderPending.fix_db_tables;
+    _syncPending.bookmarks_to_write = _syncPending.bookmarks_to_write or olderPending.bookmarks_to_write;
+    _syncPending.nodes_to_rm_set.insert(olderPending.nodes_to_rm_set.begin(), olderPending.nodes_to_rm_set.end());
+    for (const auto& [node_id, olderState] : olderPending.nodes_to_write_dict) {
+        if (_syncPending.nodes_to_rm_set.count(node_id)) {
+            continue;
+        }
+        const auto it = _syncPending.nodes_to_write_dict.find(node_id);
+        if (_syncPending.nodes_to_write_dict.end() == it) {
+            _syncPending.nodes_to_write_dict[node_id] = olderState;
+        }
+        else {
+            // the older state knows whether the node is already in the document
+            CtStorageNodeState& state = it->second;
+            state.is_update_of_existing = olderState.is_update_of_existing;
+            state.prop = state.prop or olderState.prop;
+            state.buff = state.buff or olderState.buff;
+            state.hier = state.hier or olderState.hier;
+        }
+    }
 }
 
 Glib::RefPtr<Gsv::Buffer> CtStorageControl::get_delayed_text_buffer(const gint64 node_id,
@@ -374,6 +725,24 @@ Glib::RefPtr<Gsv::Buffer> CtStorageControl::get_delayed_text_buffer(const gint64
     return _storage->get_delayed_text_buffer(node_id, syntax, widgets);
 }
 
+bool CtStorageControl::get_delayed_raw_text(const gint64 node_id, CtStorageNodeRawText& raw_text) const
+{
+    if (not _storage) {
+        return false;
+    }
+    return _storage->get_delayed_raw_text(node_id, raw_text);
+}
+
+bool CtStorageControl::get_nodes_may_contain(const Glib::ustring& str_find,
+                                             const bool match_case,
+                                             std::unordered_set<gint64>& node_ids) const
+{
+    if (not _storage) {
+        return false;
+    }
+    return _storage->get_nodes_may_contain(str_find, match_case, node_ids);
+}
+
 /*static*/fs::path CtStorageControl::_extract_file(CtMainWin* pCtMainWin, const fs::path& file_path, Glib::ustring& password)
 {
     fs::path temp_dir = pCtMainWin->get_ct_tmp()->getHiddenDirPath(file_path);
@@ -413,6 +782,27 @@ Glib::RefPtr<Gsv::Buffer> CtStorageControl::get_delayed_text_buffer(const gint64
 }
 
 /*static*/bool CtStorageControl::_package_file(const fs::path& file_from, const fs::path& file_to, const Glib::ustring& password)
+{
+    return _package(file_to, [&](){
+        const int ret_val = CtP7zaIface::p7za_archive(file_from.c_str(), file_to.c_str(), password.c_str());
+        if (0 != ret_val) spdlog::debug("!! p7za_archive {} -> {}", file_from.c_str(), file_to.c_str());
+        return ret_val;
+    });
+}
+
+/*static*/bool CtStorageControl::_package_data(const CtDocumentData& data,
+                                               const std::string& item_name,
+                                               const fs::path& file_to,
+                                               const Glib::ustring& password)
+{
+    return _package(file_to, [&](){
+        const int ret_val = CtP7zaIface::p7za_archive_from_memory(data.bytes.get(), data.size, item_name.c_str(), file_to.c_str(), password.c_str());
+        if (0 != ret_val) spdlog::debug("!! p7za_archive_from_memory {} -> {}", item_name, file_to.c_str());
+        return ret_val;
+    });
+}
+
+/*static*/bool CtStorageControl::_package(const fs::path& file_to, const std::function<int()>& f_archive)
 {
     fs::path tmp_prev_archive;
     if (fs::is_regular_file(file_to)) {
@@ -422,8 +812,7 @@ Glib::RefPtr<Gsv::Buffer> CtStorageControl::get_delayed_text_buffer(const gint64
             spdlog::debug("!! {} {} -> {}", __FUNCTION__, file_to.c_str(), tmp_prev_archive.c_str());
         }
     }
-    if (0 != CtP7zaIface::p7za_archive(file_from.c_str(), file_to.c_str(), password.c_str())) {
-        spdlog::debug("!! p7za_archive {} -> {}", file_from.c_str(), file_to.c_str());
+    if (0 != f_archive()) {
         if (not tmp_prev_archive.empty()) {
             (void)fs::copy_file(tmp_prev_archive, file_to);
             (void)fs::remove(tmp_prev_archive);
@@ -448,12 +837,23 @@ CtStorageControl::CtStorageControl(CtMainWin* pCtMainWin)
  , _pCtConfig{pCtMainWin->get_ct_config()}
 {
     _pThreadBackupEncrypt = std::make_unique<std::thread>(std::bind(&CtStorageControl::_backupEncryptThread, this));
+    _dispatcherAsyncSaveDone.connect([this](){
+        // a notification may be late, for a save already completed by save_async_wait
+        if (_asyncSave and _asyncSave->done) {
+            _async_save_complete(true/*emitDone*/);
+        }
+    });
+    _dispatcherBackupEncryptStatus.connect(sigc::mem_fun(*this, &CtStorageControl::_on_backup_encrypt_status));
 }
 
 CtStorageControl::~CtStorageControl()
 {
+    // the window may be going, the document is put in place without notifications
+    _async_save_complete(false/*emitDone*/);
     if (_pThreadBackupEncrypt) {
         _backupEncryptKeepGoing = false;
+        // the jobs still queued are not taken anyway, room is made so that the nullptr is always queued
+        backupEncryptDEQueue.clear();
         backupEncryptDEQueue.push_back(nullptr);
         _pThreadBackupEncrypt->join();
     }
@@ -467,21 +867,39 @@ void CtStorageControl::_backupEncryptThread()
             // a nullptr is passed on purpose in order to exit the loop at app quit
             break;
         }
+        _backupEncryptBusy = true;
+        auto on_scope_exit = scope_guard([&](void*) {
+            _backupEncryptBusy = false;
+            _dispatcherBackupEncryptStatus.emit();
+        });
 
         // encrypt the file
         if (pBackupEncryptData->needEncrypt) {
+            const bool fromMemory{static_cast<bool>(pBackupEncryptData->extracted_data)};
             Glib::ustring error;
-            if (not CtStorageControl::document_integrity_check_pass(_pCtMainWin, pBackupEncryptData->extracted_copy, error)) {
+            const bool integrityOk = fromMemory ?
+                _saved_document_check_pass(pBackupEncryptData->extracted_name, &pBackupEncryptData->extracted_data, error) :
+                _saved_document_check_pass(pBackupEncryptData->extracted_copy, nullptr/*pData*/, error);
+            if (not integrityOk) {
                 spdlog::error("{} {}", __FUNCTION__, error.raw());
                 _pCtMainWin->errorsDEQueue.push_back(_("Failed integrity check of the saved document. Try File-->Save As"));
                 _pCtMainWin->dispatcherErrorMsg.emit();
                 continue;
             }
 #if defined(DEBUG_BACKUP_ENCRYPT)
-            spdlog::debug("{} integrity check ok", pBackupEncryptData->extracted_copy);
+            spdlog::debug("{} integrity check ok", fromMemory ? pBackupEncryptData->extracted_name : pBackupEncryptData->extracted_copy);
 #endif // DEBUG_BACKUP_ENCRYPT
-            const bool retValEncrypt = _package_file(pBackupEncryptData->extracted_copy, pBackupEncryptData->file_path, pBackupEncryptData->password);
-            if (not fs::remove(pBackupEncryptData->extracted_copy)) {
+            bool retValEncrypt;
+            {
+                CtStorageStatsRecorder::Span span{&_statsRecorder, CtStorageStatsRecorder::Op::Save, "archive", pBackupEncryptData->saveSeq};
+                retValEncrypt = fromMemory ?
+                    _package_data(pBackupEncryptData->extracted_data, pBackupEncryptData->extracted_name, pBackupEncryptData->file_path, pBackupEncryptData->password) :
+                    _package_file(pBackupEncryptData->extracted_copy, pBackupEncryptData->file_path, pBackupEncryptData->password);
+            }
+            if (fromMemory) {
+                pBackupEncryptData->extracted_data = CtDocumentData{};
+            }
+            else if (not fs::remove(pBackupEncryptData->extracted_copy)) {
                 spdlog::debug("!! rm {}", pBackupEncryptData->extracted_copy);
             }
             if (not retValEncrypt) {
@@ -495,17 +913,18 @@ void CtStorageControl::_backupEncryptThread()
                 continue;
             }
 #if defined(DEBUG_BACKUP_ENCRYPT)
-            spdlog::debug("{} => {}", pBackupEncryptData->extracted_copy, pBackupEncryptData->file_path);
+            spdlog::debug("{} => {}", fromMemory ? pBackupEncryptData->extracted_name : pBackupEncryptData->extracted_copy, pBackupEncryptData->file_path);
 #endif // DEBUG_BACKUP_ENCRYPT
         }
 
         if (CtBackupType::None == pBackupEncryptData->backupType) {
             continue;
         }
+        CtStorageStatsRecorder::Span span{&_statsRecorder, CtStorageStatsRecorder::Op::Save, "backup_rotate", pBackupEncryptData->saveSeq};
 
         if (CtBackupType::SingleFile == pBackupEncryptData->backupType and not pBackupEncryptData->needEncrypt) {
             Glib::ustring error;
-            if (not CtStorageControl::document_integrity_check_pass(_pCtMainWin, pBackupEncryptData->main_backup, error)) {
+            if (not _saved_document_check_pass(pBackupEncryptData->main_backup, nullptr/*pData*/, error)) {
                 spdlog::error("{} {}", __FUNCTION__, error.raw());
                 _pCtMainWin->errorsDEQueue.push_back(_("Failed integrity check of the saved document. Try File-->Save As"));
                 _pCtMainWin->dispatcherErrorMsg.emit();
@@ -751,8 +1170,12 @@ void CtStorageControl::add_nodes_from_storage(const fs::path& file_path,
     _pCtMainWin->update_window_save_needed();
 }
 
-void CtStorageCache::generate_cache(CtMainWin* pCtMainWin, const CtStorageSyncPending* pending, bool for_xml)
+void CtStorageCache::generate_cache(CtMainWin* pCtMainWin,
+                                    const CtStorageSyncPending* pending,
+                                    bool for_xml,
+                                    CtStorageStatsRecorder* pStatsRecorder/*= nullptr*/)
 {
+    CtStorageStatsRecorder::Span span{pStatsRecorder, CtStorageStatsRecorder::Op::Save, "cache"};
     std::vector<CtImagePng*> image_list;
     auto& store = pCtMainWin->get_tree_store();
     if (not pending) {
@@ -789,6 +1212,7 @@ void CtStorageCache::generate_cache(CtMainWin* pCtMainWin, const CtStorageSyncPe
         }
     }
     _parallel_fetch_pixbufers(image_list, for_xml);
+    if (pStatsRecorder) pStatsRecorder->add_images_encoded(image_list.size());
 }
 
 void CtStorageCache::_parallel_fetch_pixbufers(const std::vector<CtImagePng*>& image_widgets, bool for_xml)
@@ -824,3 +1248,27 @@ bool CtStorageCache::get_cached_image(CtImagePng* image, std::string& cached_ima
     cached_image = it->second;
     return true;
 }
+
+bool CtStorageCache::defer_image(CtImagePng* image, xmlpp::Element* p_image_node)
+{
+    if (not _deferImages) return false;
+    // the pixbuf is not changed once set, the image widget may go meanwhile
+    _deferredImages.emplace_back(p_image_node, image->get_pixbuf());
+    return true;
+}
+
+void CtStorageCache::encode_deferred_images()
+{
+    std::vector<std::string> encoded_images(_deferredImages.size());
+    CtMiscUtil::parallel_for(0, _deferredImages.size(), [&](size_t index) {
+        g_autofree gchar* pBuffer{NULL};
+        gsize buffer_size;
+        _deferredImages[index].second->save_to_buffer(pBuffer, buffer_size, "png");
+        encoded_images[index] = Glib::Base64::encode(std::string(pBuffer, buffer_size));
+    });
+    // the xml tree is changed by one thread
+    for (size_t i = 0; i < _deferredImages.size(); ++i) {
+        _deferredImages[i].first->add_child_text(encoded_images[i]);
+    }
+    _deferredImages.clear();
+}
@@ -24,8 +24,12 @@
 #pragma once
 
 #include "ct_types.h"
+#include "ct_storage_stats.h"
 #include <glibmm/miscutils.h>
+#include <glibmm/dispatcher.h>
+#include <gdkmm/pixbuf.h>
 #include <thread>
+#include <atomic>
 
 class CtMainWin;
 class CtTreeStore;
@@ -57,12 +61,33 @@ public:
     virtual ~CtStorageControl();
 
     ThreadSafeDEQueue<std::shared_ptr<CtBackupEncryptData>,1000> backupEncryptDEQueue;
+    // queues a job for the backup/encrypt thread, a pending archive job of the same document is superseded;
+    // with the queue full the caller (the GTK thread, also for every node backup of a multiple files
+    // document) waits for the backup/encrypt thread to take the next job rather than the job being dropped
+    void backup_encrypt_push(std::shared_ptr<CtBackupEncryptData> pBackupEncryptData);
+    size_t get_backup_encrypt_superseded() const { return _backupEncryptSuperseded; }
 
     bool save(bool need_vacuum, Glib::ustring& error);
+    /**
+     * @brief Save with the writing on a worker thread, if the storage can snapshot the tree
+     * The pending changes are taken by the snapshot and come back if the writing fails
+     * @warning Only the single file xml documents (ctd/ctz) can snapshot the tree; the snapshot itself
+     * is the xml tree of the whole document, built on the GTK thread, only the encoding of the images,
+     * the formatting and the writing are on the worker thread
+     * @return false if not started, then with an empty error the synchronous save is to be used
+     */
+    bool save_async(Glib::ustring& error);
+    // completes a running save_async on the spot
+    void save_async_wait();
+    bool is_saving_async() const { return static_cast<bool>(_asyncSave); }
+    // on the GTK thread at the end of a save_async, with false and the error if it was rolled back
+    sigc::signal<void, bool, Glib::ustring> signal_save_done;
     bool try_reopen(Glib::ustring& error);
     Glib::RefPtr<Gsv::Buffer> get_delayed_text_buffer(const gint64 node_id,
                                                       const std::string& syntax,
                                                       std::list<CtAnchoredWidget*>& widgets) const;
+    bool get_delayed_raw_text(const gint64 node_id, CtStorageNodeRawText& raw_text) const;
+    bool get_nodes_may_contain(const Glib::ustring& str_find, const bool match_case, std::unordered_set<gint64>& node_ids) const;
 
     const fs::path& get_file_path() { return _file_path; }
     time_t get_mod_time() { return _mod_time; }
@@ -70,6 +95,8 @@ public:
     fs::path get_file_dir()  { return _file_path.empty() ? "" : _file_path.parent_path(); }
 
     const CtStorageSyncPending* get_storage_sync_pending() { return &_syncPending; }
+    // timing spans and counters of the latest load and save
+    CtStorageStats get_stats() const { return _statsRecorder.get(); }
 
     void pending_edit_db_node_prop(const gint64 node_id);
     void pending_edit_db_node_buff(const gint64 node_id);
@@ -90,9 +117,50 @@ private:
     static std::unique_ptr<CtStorageEntity> _get_entity_by_type(CtMainWin* pCtMainWin, CtDocType file_type);
     static fs::path _extract_file(CtMainWin* pCtMainWin, const fs::path& file_path, Glib::ustring& password);
     static bool     _package_file(const fs::path& file_from, const fs::path& file_to, const Glib::ustring& password);
+    static bool     _package_data(const CtDocumentData& data, const std::string& item_name, const fs::path& file_to, const Glib::ustring& password);
+    static bool     _package(const fs::path& file_to, const std::function<int()>& f_archive);
+
+    const inline static size_t CHECKED_FILES_MAX{4u};
 
     CtStorageControl(CtMainWin* pCtMainWin);
 
+    void _main_backup_make(const fs::path& main_backup, const CtDocType doc_type, const bool need_encrypt);
+    void _main_backup_restore(const fs::path& main_backup, const bool need_main_backup);
+    void _backup_encrypt_enqueue(const std::string& str_timestamp,
+                                 const fs::path& main_backup,
+                                 const bool need_main_backup,
+                                 const bool need_encrypt);
+    void _on_backup_encrypt_status();
+    void _sync_pending_merge_older(const CtStorageSyncPending& olderPending);
+    void _stats_bytes_written_update();
+    // cheap check of a saved document (in pData if not null), skipped if the same content passed already
+    bool _saved_document_check_pass(const fs::path& file_path, const CtDocumentData* pData, Glib::ustring& error);
+    static std::string _get_file_key(const fs::path& file_path);
+    static const char* _get_backend_name(const CtDocType doc_type);
+    void _async_save_complete(const bool emitDone);
+
+    // size and modification time of a file, to tell whether it changed
+    struct CtFileStamp
+    {
+        guint64 size{0};
+        guint64 mtime_usec{0};
+        bool operator==(const CtFileStamp& other) const { return size == other.size and mtime_usec == other.mtime_usec; }
+    };
+    static CtFileStamp _get_file_stamp(const fs::path& file_path);
+
+    struct CtAsyncSave
+    {
+        std::thread          thread;
+        std::atomic<bool>    done{false};
+        bool                 ok{false};
+        Glib::ustring        error;
+        std::string          str_timestamp;
+        fs::path             main_backup;
+        bool                 need_main_backup{false};
+        bool                 need_encrypt{false};
+        CtStorageSyncPending syncPending; // taken by the snapshot, for the rollback
+    };
+
     CtMainWin*                 const _pCtMainWin;
     CtConfig*                  const _pCtConfig;
     fs::path                         _file_path;
@@ -101,6 +169,15 @@ private:
     fs::path                         _extracted_file_path;
     std::unique_ptr<CtStorageEntity> _storage;
     CtStorageSyncPending             _syncPending;
+    CtFileStamp                      _lastBackupStamp; // of the file copied into the latest backup, zero if none
+    std::unique_ptr<CtAsyncSave>     _asyncSave;
+    CtStorageStatsRecorder           _statsRecorder;
+    Glib::Dispatcher                 _dispatcherAsyncSaveDone;
+    Glib::Dispatcher                 _dispatcherBackupEncryptStatus;
+    std::atomic<size_t>              _backupEncryptSuperseded{0}; // archive jobs dropped for a newer state since the queue drained
+    std::atomic<bool>                _backupEncryptBusy{false};
+
+    std::list<std::string>           _checkedFiles; // keys of the saved documents files that passed the check, backup/encrypt thread only
 
     std::unique_ptr<std::thread> _pThreadBackupEncrypt;
     void _backupEncryptThread();
@@ -108,14 +185,25 @@ private:
 };
 
 class CtImagePng;
+namespace xmlpp { class Element; }
 class CtStorageCache
 {
 public:
-    void generate_cache(CtMainWin* pCtMainWin, const CtStorageSyncPending* pending, bool for_xml);
+    void generate_cache(CtMainWin* pCtMainWin,
+                        const CtStorageSyncPending* pending,
+                        bool for_xml,
+                        CtStorageStatsRecorder* pStatsRecorder = nullptr);
     bool get_cached_image(CtImagePng* image, std::string& cached_image);
 
+    // the images of an xml snapshot are encoded later, by the thread writing it
+    void set_defer_images(const bool deferImages) { _deferImages = deferImages; }
+    bool defer_image(CtImagePng* image, xmlpp::Element* p_image_node);
+    void encode_deferred_images();
+
 private:
     void _parallel_fetch_pixbufers(const std::vector<CtImagePng*>& image_widgets, bool for_xml);
 
     std::unordered_map<CtImagePng*, std::string> _cached_images;
+    bool _deferImages{false};
+    std::vector<std::pair<xmlpp::Element*, Glib::RefPtr<Gdk::Pixbuf>>> _deferredImages;
 };
@@ -24,6 +24,7 @@
 #include "ct_storage_multifile.h"
 #include "ct_storage_xml.h"
 #include "ct_storage_control.h"
+#include "ct_storage_stats.h"
 #include "ct_main_win.h"
 #include "ct_logging.h"
 #include <glib/gstdio.h>
@@ -64,11 +65,12 @@ bool CtStorageMultiFile::save_treestore(const fs::path& dir_path,
             node_state.hier = true;
 
             CtStorageCache storage_cache;
-            storage_cache.generate_cache(_pCtMainWin, nullptr/*all nodes*/, false/*for_xml*/);
+            storage_cache.generate_cache(_pCtMainWin, nullptr/*all nodes*/, false/*for_xml*/, _pStatsRecorder);
 
             std::list<gint64> subnodes_list;
 
             // save nodes
+            CtStorageStatsRecorder::Span span{_pStatsRecorder, CtStorageStatsRecorder::Op::Save, "nodes"};
             if ( CtExporting::NONESAVEAS == export_type or
                  CtExporting::ALL_TREE == export_type )
             {
@@ -116,13 +118,14 @@ bool CtStorageMultiFile::save_treestore(const fs::path& dir_path,
         else {
             // or need just update some info
             CtStorageCache storage_cache;
-            storage_cache.generate_cache(_pCtMainWin, &syncPending, false/*for_xml*/);
+            storage_cache.generate_cache(_pCtMainWin, &syncPending, false/*for_xml*/, _pStatsRecorder);
 
             // update bookmarks
             if (syncPending.bookmarks_to_write) {
                 _write_bookmarks_to_disk(ct_tree_store.bookmarks_get());
             }
             // update changed nodes
+            CtStorageStatsRecorder::Span span{_pStatsRecorder, CtStorageStatsRecorder::Op::Save, "nodes"};
             const std::list<std::pair<CtTreeIter, CtStorageNodeState>> nodes_to_write = CtStorageControl::get_sorted_by_level_nodes_to_write(
                 &_pCtMainWin->get_tree_store(), syncPending.nodes_to_write_dict);
             bool any_hier{false};
@@ -241,7 +244,7 @@ void CtStorageMultiFile::_remove_disk_node_with_children(const gint64 node_id)
         pBackupEncryptData->needEncrypt = false;
         pBackupEncryptData->file_path = _dir_path.string();
         pBackupEncryptData->main_backup = curr_node_dirpath.string();
-        _pCtMainWin->get_ct_storage()->backupEncryptDEQueue.push_back(pBackupEncryptData);
+        _pCtMainWin->get_ct_storage()->backup_encrypt_push(pBackupEncryptData);
         _already_queued_for_removal.insert(curr_node_id);
     };
     fs::path node_dirpath;
@@ -296,6 +299,7 @@ bool CtStorageMultiFile::_nodes_to_multifile(const CtTreeIter* ct_tree_iter,
                                              const int start_offset/*= 0*/,
                                              const int end_offset/*=-1*/)
 {
+    if (_pStatsRecorder) _pStatsRecorder->add_nodes(CtStorageStatsRecorder::Op::Save, 1);
     if (CtExporting::NONESAVE == export_type and
         node_state.hier and
         node_state.is_update_of_existing and
@@ -356,7 +360,7 @@ bool CtStorageMultiFile::_nodes_to_multifile(const CtTreeIter* ct_tree_iter,
             pBackupEncryptData->needEncrypt = false;
             pBackupEncryptData->file_path = _dir_path.string();
             pBackupEncryptData->main_backup = dir_before_save.string();
-            _pCtMainWin->get_ct_storage()->backupEncryptDEQueue.push_back(pBackupEncryptData);
+            _pCtMainWin->get_ct_storage()->backup_encrypt_push(pBackupEncryptData);
         }
     }
     // subnodes?
@@ -520,6 +524,10 @@ bool CtStorageMultiFile::populate_treestore(const fs::path& dir_path, Glib::ustr
             ct_tree_store.get_node_data(ctTreeIter, nodeData, false/*loadTextBuffer*/);
             ct_tree_store.update_node_data(ctTreeIter, nodeData);
         }
+        if (not _isDryRun) {
+            _contentIndexConn.disconnect(); // the idle indexing of a previous populate
+            _contentIndexConn = CtStorageXmlHelper::content_index_start(_delayed_text_buffers, _contentIndex);
+        }
         return true;
     }
     catch (std::exception& e) {
@@ -597,6 +605,29 @@ Glib::RefPtr<Gsv::Buffer> CtStorageMultiFile::get_delayed_text_buffer(const gint
     auto ret_buffer = CtStorageXmlHelper{_pCtMainWin}.create_buffer_and_widgets_from_xml(xml_element, syntax, widgets, nullptr, -1, multifile_dir.string());
     if (ret_buffer) {
         _delayed_text_buffers.erase(node_id);
+        _contentIndex.remove(node_id);
     }
     return ret_buffer;
 }
+
+bool CtStorageMultiFile::get_delayed_raw_text(const gint64 node_id, CtStorageNodeRawText& raw_text) const
+{
+    const auto it = _delayed_text_buffers.find(node_id);
+    if (_delayed_text_buffers.end() == it) {
+        return false;
+    }
+    auto xml_element = dynamic_cast<xmlpp::Element*>(it->second->get_root_node()->get_first_child());
+    if (not xml_element) {
+        return false;
+    }
+    // the embedded files names are in node.xml, the blobs on disk are not needed
+    CtStorageXmlHelper::raw_text_from_xml(xml_element, raw_text);
+    return true;
+}
+
+bool CtStorageMultiFile::get_nodes_may_contain(const Glib::ustring& str_find,
+                                                const bool/*match_case*/,
+                                                std::unordered_set<gint64>& node_ids) const
+{
+    return CtStorageXmlHelper::content_index_query(_delayed_text_buffers, _contentIndex, str_find, node_ids);
+}
@@ -25,6 +25,7 @@
 
 #include "ct_types.h"
 #include "ct_filesystem.h"
+#include "ct_trigram_index.h"
 #include <glibmm/refptr.h>
 #include <gtksourceviewmm/buffer.h>
 #include <gtkmm/treeiter.h>
@@ -55,6 +56,7 @@ public:
     CtStorageMultiFile(CtMainWin* pCtMainWin)
      : _pCtMainWin{pCtMainWin}
     {}
+    ~CtStorageMultiFile() override { _contentIndexConn.disconnect(); }
 
     void close_connect() override {}
     void reopen_connect() override {}
@@ -75,11 +77,17 @@ public:
     Glib::RefPtr<Gsv::Buffer> get_delayed_text_buffer(const gint64 node_id,
                                                       const std::string& syntax,
                                                       std::list<CtAnchoredWidget*>& widgets) const override;
+    bool get_delayed_raw_text(const gint64 node_id, CtStorageNodeRawText& raw_text) const override;
+    bool get_nodes_may_contain(const Glib::ustring& str_find,
+                               const bool match_case,
+                               std::unordered_set<gint64>& node_ids) const override;
 
 private:
     CtMainWin* const _pCtMainWin;
     fs::path         _dir_path;
     mutable CtDelayedTextBufferMap _delayed_text_buffers;
+    mutable CtTrigramIndex _contentIndex;
+    sigc::connection _contentIndexConn;
     std::unordered_set<gint64> _already_queued_for_removal;
 
     fs::path _get_node_dirpath(const CtTreeIter& ct_tree_iter) const;
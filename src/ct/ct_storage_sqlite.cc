@@ -24,6 +24,7 @@
 #include "ct_storage_sqlite.h"
 #include "ct_storage_xml.h"
 #include "ct_storage_control.h"
+#include "ct_storage_stats.h"
 #include "ct_main_win.h"
 #include "ct_logging.h"
 #include <unistd.h>
@@ -108,6 +109,18 @@ const char CtStorageSqlite::TABLE_BOOKMARK_CREATE[]{"CREATE TABLE bookmark ("
 const char CtStorageSqlite::TABLE_BOOKMARK_INSERT[]{"INSERT INTO bookmark VALUES(?,?)"};
 const char CtStorageSqlite::TABLE_BOOKMARK_DELETE[]{"DELETE FROM bookmark"};
 
+/* full text index of the node content (text, codeboxes, tables cells, anchors and files names),
+   rowid is the node_id and ts_lastsave tells if the row is up to date with the node row
+   (the document may have been saved by a version not writing the index) */
+const char CtStorageSqlite::TABLE_NODE_FTS_CREATE[]{"CREATE VIRTUAL TABLE node_fts USING fts5("
+"txt,"
+"ts_lastsave UNINDEXED,"
+"tokenize='trigram'"
+")"
+};
+const char CtStorageSqlite::TABLE_NODE_FTS_INSERT[]{"INSERT INTO node_fts(rowid, txt, ts_lastsave) VALUES(?,?,?)"};
+const char CtStorageSqlite::TABLE_NODE_FTS_DELETE[]{"DELETE FROM node_fts WHERE rowid=?"};
+
 const Glib::ustring CtStorageSqlite::ERR_SQLITE_PREPV2{"!! sqlite3_prepare_v2: "};
 const Glib::ustring CtStorageSqlite::ERR_SQLITE_STEP{"!! sqlite3_step: "};
 
@@ -230,6 +243,85 @@ void CtStorageSqlite::try_reopen()
     (void)_check_database_integrity();
 }
 
+bool CtStorageSqlite::structure_check(const fs::path& file_path, Glib::ustring& error)
+{
+    _close_db();
+    try {
+        _open_db(file_path);
+        _file_path = file_path;
+    }
+    catch (std::exception& e) {
+        _close_db();
+        error = e.what();
+        return false;
+    }
+    return _structure_check_db(error);
+}
+
+bool CtStorageSqlite::structure_check_from_memory(const std::string_view data, Glib::ustring& error)
+{
+    try {
+        _open_db_from_memory(data);
+    }
+    catch (std::exception& e) {
+        error = e.what();
+        return false;
+    }
+    return _structure_check_db(error);
+}
+
+bool CtStorageSqlite::_structure_check_db(Glib::ustring& error)
+{
+    try {
+        // b-tree pages and records, without the cross check of the indexes of integrity_check
+        auto corrupted_rows = get_quick_check_issues(_pDb);
+        if (corrupted_rows) {
+            error = str::join(*corrupted_rows, "\n");
+            _close_db();
+            return false;
+        }
+        Sqlite3StmtAuto stmt{_pDb, "SELECT COUNT(*) FROM sqlite_master WHERE type='table' AND name IN ('node','codebox','grid','image','children','bookmark')"};
+        if (stmt.is_bad()) {
+            throw std::runtime_error(ERR_SQLITE_PREPV2 + sqlite3_errmsg(_pDb));
+        }
+        if (sqlite3_step(stmt) != SQLITE_ROW or sqlite3_column_int(stmt, 0) != 6) {
+            throw std::runtime_error("missing tables");
+        }
+    }
+    catch (std::exception& e) {
+        _close_db();
+        error = e.what();
+        return false;
+    }
+    _close_db();
+    return true;
+}
+
+bool CtStorageSqlite::get_document_data(const fs::path& file_path, CtDocumentData& data)
+{
+#if defined(CT_SQLITE_SERIALIZE)
+    if (not _pDb or fs::file_size(file_path) > SERIALIZE_MAX_SIZE) {
+        return false;
+    }
+    sqlite3_int64 size{0};
+    unsigned char* pData = sqlite3_serialize(_pDb, "main", &size, 0/*mFlags*/);
+    if (not pData) {
+        spdlog::error("{} {}", __FUNCTION__, sqlite3_errmsg(_pDb));
+        return false;
+    }
+    // the serialized copy is handed over as it is, freed by sqlite with the last reference
+    data.bytes = std::shared_ptr<const char>{reinterpret_cast<const char*>(pData), [](const char* pBytes){
+        sqlite3_free(const_cast<char*>(pBytes));
+    }};
+    data.size = static_cast<size_t>(size);
+    return true;
+#else // !CT_SQLITE_SERIALIZE
+    (void)file_path;
+    (void)data;
+    return false;
+#endif // !CT_SQLITE_SERIALIZE
+}
+
 bool CtStorageSqlite::populate_treestore(const fs::path& file_path, Glib::ustring& error)
 {
     _close_db();
@@ -240,6 +332,8 @@ bool CtStorageSqlite::populate_treestore(const fs::path& file_path, Glib::ustrin
 
         if (not _check_database_integrity()) return false;
 
+        _ftsAvailable = _fts_table_exists();
+
         // load bookmarks
         Sqlite3StmtAuto stmt{_pDb, "SELECT node_id FROM bookmark ORDER BY sequence ASC"};
         if (stmt.is_bad()) {
@@ -291,6 +385,7 @@ bool CtStorageSqlite::save_treestore(const fs::path& file_path,
             _file_path = file_path;
 
             _create_all_tables_in_db();
+            _ftsAvailable = _fts_create_table();
             if ( CtExporting::NONESAVEAS == export_type or
                  CtExporting::ALL_TREE == export_type )
             {
@@ -303,7 +398,7 @@ bool CtStorageSqlite::save_treestore(const fs::path& file_path,
             node_state.hier = true;
 
             CtStorageCache storage_cache;
-            storage_cache.generate_cache(_pCtMainWin, nullptr/*all nodes*/, false/*for_xml*/);
+            storage_cache.generate_cache(_pCtMainWin, nullptr/*all nodes*/, false/*for_xml*/, _pStatsRecorder);
 
             // function to iterate through the tree
             std::function<void(CtTreeIter, const gint64, const gint64)> f_save_node;
@@ -331,6 +426,7 @@ bool CtStorageSqlite::save_treestore(const fs::path& file_path,
             };
 
             // saving nodes
+            CtStorageStatsRecorder::Span span{_pStatsRecorder, CtStorageStatsRecorder::Op::Save, "nodes"};
             gint64 sequence{0};
             if ( CtExporting::NONESAVEAS == export_type or
                  CtExporting::ALL_TREE == export_type )
@@ -350,7 +446,7 @@ bool CtStorageSqlite::save_treestore(const fs::path& file_path,
         // or need just update some info
         else {
             CtStorageCache storage_cache;
-            storage_cache.generate_cache(_pCtMainWin, &syncPending, false/*for_xml*/);
+            storage_cache.generate_cache(_pCtMainWin, &syncPending, false/*for_xml*/, _pStatsRecorder);
 
             // check db tables columns (for document created with old version)
             if (syncPending.fix_db_tables) {
@@ -361,6 +457,7 @@ bool CtStorageSqlite::save_treestore(const fs::path& file_path,
                 _write_bookmarks_to_db(_pCtMainWin->get_tree_store().bookmarks_get());
             }
             // update changed nodes
+            CtStorageStatsRecorder::Span span{_pStatsRecorder, CtStorageStatsRecorder::Op::Save, "nodes"};
             const std::list<std::pair<CtTreeIter, CtStorageNodeState>> nodes_to_write = CtStorageControl::get_sorted_by_level_nodes_to_write(
                 &_pCtMainWin->get_tree_store(), syncPending.nodes_to_write_dict);
             for (const auto& node_pair : nodes_to_write) {
@@ -379,6 +476,10 @@ bool CtStorageSqlite::save_treestore(const fs::path& file_path,
             for (const gint64 node_id : syncPending.nodes_to_rm_set) {
                 _remove_db_node_with_children(node_id);
             }
+            // the content index is missing in documents saved by older versions
+            if (syncPending.fix_db_tables and not _ftsAvailable and _fts_create_table()) {
+                _fts_fill_table();
+            }
         }
         return true;
     }
@@ -395,6 +496,72 @@ void CtStorageSqlite::vacuum()
     _exec_no_callback("REINDEX");
 }
 
+bool CtStorageSqlite::backup_to(const fs::path& backup_path, Glib::ustring& error)
+{
+    if (not _pDb) {
+        return false;
+    }
+    sqlite3* pDbBackup{nullptr};
+    if (sqlite3_open(backup_path.c_str(), &pDbBackup) != SQLITE_OK) {
+        error = std::string("sqlite3_open: ") + sqlite3_errmsg(pDbBackup);
+        sqlite3_close(pDbBackup);
+        return false;
+    }
+    // page based copy through the open connection, whose page cache stays warm
+    sqlite3_backup* pBackup = sqlite3_backup_init(pDbBackup, "main", _pDb, "main");
+    if (not pBackup) {
+        error = std::string("sqlite3_backup_init: ") + sqlite3_errmsg(pDbBackup);
+        sqlite3_close(pDbBackup);
+        return false;
+    }
+    int rc;
+    int busy_waited_ms{0};
+    do {
+        rc = sqlite3_backup_step(pBackup, CtStorageSqlite::BACKUP_STEP_PAGES);
+        if (SQLITE_BUSY == rc or SQLITE_LOCKED == rc) {
+            if (busy_waited_ms >= CtStorageSqlite::BACKUP_BUSY_MAX_WAIT_MS) {
+                // on the GTK thread, not to wait indefinitely for a lock held by another process
+                break;
+            }
+            sqlite3_sleep(CtStorageSqlite::BACKUP_BUSY_SLEEP_MS);
+            busy_waited_ms += CtStorageSqlite::BACKUP_BUSY_SLEEP_MS;
+        }
+    } while (SQLITE_OK == rc or SQLITE_BUSY == rc or SQLITE_LOCKED == rc);
+    const bool completed = SQLITE_DONE == rc;
+    // the error of a step, if any, is returned by finish
+    rc = sqlite3_backup_finish(pBackup);
+    if (SQLITE_OK != rc) {
+        error = std::string("sqlite3_backup_step: ") + sqlite3_errmsg(pDbBackup);
+    }
+    else if (not completed) {
+        error = fmt::format("sqlite3_backup_step: still busy after {} ms", busy_waited_ms);
+    }
+    sqlite3_close(pDbBackup);
+    return SQLITE_OK == rc and completed;
+}
+
+void CtStorageSqlite::_open_db_from_memory(const std::string_view data)
+{
+#if defined(CT_SQLITE_SERIALIZE)
+    _close_db();
+    if (sqlite3_open(":memory:", &_pDb) != SQLITE_OK) {
+        std::string error = sqlite3_errmsg(_pDb);
+        _close_db();
+        throw std::runtime_error(std::string("sqlite3_open: ") + error);
+    }
+    // read only on the caller buffer, that outlives this storage
+    unsigned char* pData = reinterpret_cast<unsigned char*>(const_cast<char*>(data.data()));
+    if (sqlite3_deserialize(_pDb, "main", pData, data.size(), data.size(), SQLITE_DESERIALIZE_READONLY) != SQLITE_OK) {
+        std::string error = sqlite3_errmsg(_pDb);
+        _close_db();
+        throw std::runtime_error(std::string("sqlite3_deserialize: ") + error);
+    }
+#else // !CT_SQLITE_SERIALIZE
+    (void)data;
+    throw std::runtime_error("sqlite3_deserialize not available");
+#endif // !CT_SQLITE_SERIALIZE
+}
+
 void CtStorageSqlite::_open_db(const fs::path& path)
 {
     if (_pDb) return;
@@ -517,6 +684,78 @@ Glib::RefPtr<Gsv::Buffer> CtStorageSqlite::get_delayed_text_buffer(const gint64
     return rRetTextBuffer;
 }
 
+bool CtStorageSqlite::get_delayed_raw_text(const gint64 node_id, CtStorageNodeRawText& raw_text) const
+{
+    Sqlite3StmtAuto stmt{_pDb, "SELECT txt, syntax, has_codebox, has_table, has_image FROM node WHERE node_id=?"};
+    if (stmt.is_bad()) {
+        spdlog::error("{}: {}", ERR_SQLITE_PREPV2, sqlite3_errmsg(_pDb));
+        return false;
+    }
+    sqlite3_bind_int64(stmt, 1, node_id);
+    if (sqlite3_step(stmt) != SQLITE_ROW) {
+        return false;
+    }
+    const char* textContent = safe_sqlite3_column_text(stmt, 0);
+    const std::string syntax = safe_sqlite3_column_text(stmt, 1);
+    if (CtConst::RICH_TEXT_ID != syntax) {
+        raw_text.text = textContent;
+        return true;
+    }
+    xmlpp::DomParser parser;
+    if (not CtXmlHelper::safe_parse_memory(parser, textContent)) {
+        spdlog::error("!! xml read: {}", textContent);
+        return false;
+    }
+    CtStorageXmlHelper::raw_text_from_xml(parser.get_document()->get_root_node(), raw_text);
+
+    if (sqlite3_column_int64(stmt, 2)) {
+        Sqlite3StmtAuto stmtCodebox{_pDb, "SELECT txt FROM codebox WHERE node_id=?"};
+        if (stmtCodebox.is_bad()) {
+            spdlog::error("{}: {}", ERR_SQLITE_PREPV2, sqlite3_errmsg(_pDb));
+            return false;
+        }
+        sqlite3_bind_int64(stmtCodebox, 1, node_id);
+        while (SQLITE_ROW == sqlite3_step(stmtCodebox)) {
+            raw_text.objects_text.push_back(safe_sqlite3_column_text(stmtCodebox, 0));
+        }
+    }
+    if (sqlite3_column_int64(stmt, 3)) {
+        Sqlite3StmtAuto stmtTable{_pDb, "SELECT txt FROM grid WHERE node_id=?"};
+        if (stmtTable.is_bad()) {
+            spdlog::error("{}: {}", ERR_SQLITE_PREPV2, sqlite3_errmsg(_pDb));
+            return false;
+        }
+        sqlite3_bind_int64(stmtTable, 1, node_id);
+        while (SQLITE_ROW == sqlite3_step(stmtTable)) {
+            xmlpp::DomParser tableParser;
+            if (not CtXmlHelper::safe_parse_memory(tableParser, safe_sqlite3_column_text(stmtTable, 0))) {
+                return false;
+            }
+            CtStorageXmlHelper::raw_text_from_table_xml(tableParser.get_document()->get_root_node(), raw_text);
+        }
+    }
+    if (sqlite3_column_int64(stmt, 4)) {
+        // the png column is not read
+        Sqlite3StmtAuto stmtImage{_pDb, "SELECT anchor, filename FROM image WHERE node_id=?"};
+        if (stmtImage.is_bad()) {
+            spdlog::error("{}: {}", ERR_SQLITE_PREPV2, sqlite3_errmsg(_pDb));
+            return false;
+        }
+        sqlite3_bind_int64(stmtImage, 1, node_id);
+        while (SQLITE_ROW == sqlite3_step(stmtImage)) {
+            const Glib::ustring anchorName = safe_sqlite3_column_text(stmtImage, 0);
+            const Glib::ustring fileName = safe_sqlite3_column_text(stmtImage, 1);
+            if (not anchorName.empty()) {
+                raw_text.objects_text.push_back(anchorName);
+            }
+            else if (not fileName.empty() and fileName != CtImageLatex::LatexSpecialFilename) {
+                raw_text.objects_text.push_back(fileName);
+            }
+        }
+    }
+    return true;
+}
+
 void CtStorageSqlite::_image_from_db(const gint64& nodeId, std::list<CtAnchoredWidget*>& anchoredWidgets) const
 {
     Sqlite3StmtAuto stmt{_pDb, "SELECT * FROM image WHERE node_id=? ORDER BY offset ASC"};
@@ -651,6 +890,125 @@ void CtStorageSqlite::_create_all_tables_in_db()
     _exec_no_callback(TABLE_BOOKMARK_CREATE);
 }
 
+bool CtStorageSqlite::_fts_table_exists()
+{
+    Sqlite3StmtAuto stmt{_pDb, "SELECT 1 FROM sqlite_master WHERE type='table' AND name='node_fts'"};
+    if (stmt.is_bad()) {
+        return false;
+    }
+    return SQLITE_ROW == sqlite3_step(stmt);
+}
+
+bool CtStorageSqlite::_fts_create_table()
+{
+    char* p_err_msg{nullptr};
+    if (SQLITE_OK != sqlite3_exec(_pDb, TABLE_NODE_FTS_CREATE, nullptr, nullptr, &p_err_msg)) {
+        // sqlite built without fts5 or older than 3.34 (trigram tokenizer)
+        spdlog::debug("no content index: {}", p_err_msg ? p_err_msg : "");
+        sqlite3_free(p_err_msg);
+        return false;
+    }
+    return true;
+}
+
+void CtStorageSqlite::_fts_fill_table()
+{
+    std::list<std::pair<gint64,gint64>> nodes;
+    {
+        Sqlite3StmtAuto stmt{_pDb, "SELECT node_id, ts_lastsave FROM node"};
+        if (stmt.is_bad()) {
+            _fts_drop_table(ERR_SQLITE_PREPV2 + sqlite3_errmsg(_pDb));
+            return;
+        }
+        while (SQLITE_ROW == sqlite3_step(stmt)) {
+            nodes.push_back(std::make_pair(sqlite3_column_int64(stmt, 0), sqlite3_column_int64(stmt, 1)));
+        }
+    }
+    _ftsAvailable = true;
+    try {
+        _exec_no_callback("BEGIN");
+        for (const auto& node_pair : nodes) {
+            CtStorageNodeRawText raw_text;
+            if (not get_delayed_raw_text(node_pair.first, raw_text)) {
+                _fts_drop_table(fmt::format("node {} content not readable", node_pair.first));
+                break;
+            }
+            std::string fts_text = raw_text.text;
+            for (const Glib::ustring& obj_text : raw_text.objects_text) {
+                fts_text += '\n';
+                fts_text += obj_text.raw();
+            }
+            _fts_write_node(node_pair.first, fts_text, node_pair.second);
+            if (not _ftsAvailable) break;
+        }
+        _exec_no_callback("COMMIT");
+    }
+    catch (std::exception& e) {
+        (void)sqlite3_exec(_pDb, "ROLLBACK", nullptr, nullptr, nullptr);
+        _fts_drop_table(e.what());
+    }
+    spdlog::debug("content index of {} nodes", nodes.size());
+}
+
+void CtStorageSqlite::_fts_write_node(const gint64 node_id, const std::string& fts_text, const gint64 ts_lastsave)
+{
+    try {
+        _exec_bind_int64(TABLE_NODE_FTS_DELETE, node_id);
+        Sqlite3StmtAuto stmt{_pDb, TABLE_NODE_FTS_INSERT};
+        if (stmt.is_bad()) {
+            throw std::runtime_error(ERR_SQLITE_PREPV2 + sqlite3_errmsg(_pDb));
+        }
+        sqlite3_bind_int64(stmt, 1, node_id);
+        sqlite3_bind_text(stmt, 2, fts_text.c_str(), fts_text.size(), SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 3, ts_lastsave);
+        if (sqlite3_step(stmt) != SQLITE_DONE) {
+            throw std::runtime_error(ERR_SQLITE_STEP + sqlite3_errmsg(_pDb));
+        }
+    }
+    catch (std::exception& e) {
+        _fts_drop_table(e.what());
+    }
+}
+
+void CtStorageSqlite::_fts_drop_table(const std::string& reason)
+{
+    // the index is an optimisation only, a broken one is dropped and rebuilt at a later save
+    spdlog::warn("!! content index dropped: {}", reason);
+    _ftsAvailable = false;
+    (void)sqlite3_exec(_pDb, "DROP TABLE IF EXISTS node_fts", nullptr, nullptr, nullptr);
+}
+
+bool CtStorageSqlite::get_nodes_may_contain(const Glib::ustring& str_find,
+                                            const bool match_case,
+                                            std::unordered_set<gint64>& node_ids) const
+{
+    // the trigram tokenizer cannot answer for less than 3 characters and
+    // folds the case of ascii characters only the same way as the regex does
+    if (not _ftsAvailable or str_find.size() < 3u or (not match_case and not str_find.is_ascii())) {
+        return false;
+    }
+    // the nodes without an up to date index row are all returned as they are unknown
+    Sqlite3StmtAuto stmt{_pDb, "SELECT node.node_id FROM node LEFT JOIN node_fts ON node_fts.rowid=node.node_id"
+                               " WHERE node_fts.rowid IS NULL OR node_fts.ts_lastsave IS NOT node.ts_lastsave"
+                               " UNION SELECT rowid FROM node_fts WHERE node_fts MATCH ?"};
+    if (stmt.is_bad()) {
+        spdlog::error("{}: {}", ERR_SQLITE_PREPV2, sqlite3_errmsg(_pDb));
+        return false;
+    }
+    const std::string fts_phrase = "\"" + str::replace(str_find.raw(), "\"", "\"\"") + "\"";
+    sqlite3_bind_text(stmt, 1, fts_phrase.c_str(), fts_phrase.size(), SQLITE_STATIC);
+    int ret_step;
+    while (SQLITE_ROW == (ret_step = sqlite3_step(stmt))) {
+        node_ids.insert(sqlite3_column_int64(stmt, 0));
+    }
+    if (SQLITE_DONE != ret_step) {
+        spdlog::error("{}: {}", ERR_SQLITE_STEP, sqlite3_errmsg(_pDb));
+        node_ids.clear();
+        return false;
+    }
+    return true;
+}
+
 void CtStorageSqlite::_write_bookmarks_to_db(const std::list<gint64>& bookmarks)
 {
     _exec_no_callback(TABLE_BOOKMARK_DELETE);
@@ -680,6 +1038,7 @@ void CtStorageSqlite::_write_node_to_db(const CtTreeIter* ct_tree_iter,
                                         const CtExporting export_type,
                                         const std::map<gint64, gint64>* pExpoMasterReassign)
 {
+    if (_pStatsRecorder) _pStatsRecorder->add_nodes(CtStorageStatsRecorder::Op::Save, 1);
     const gint64 node_id = ct_tree_iter->get_node_id();
     gint64 master_id = ct_tree_iter->get_node_shared_master_id();
     if (CtExporting::SELECTED_TEXT == export_type or
@@ -749,6 +1108,7 @@ void CtStorageSqlite::_write_node_to_db(const CtTreeIter* ct_tree_iter,
     bool has_codebox{false};
     bool has_table{false};
     bool has_image{false};
+    std::string fts_text; // content index text, taken from what is written rather than read back
     if (node_state.buff) {
         if (node_state.is_update_of_existing and ((is_richtxt & 0x01) or node_state.prop)) {
             // if it's a rich text or has property changed (maybe was a rich text) clear old widgets
@@ -760,6 +1120,13 @@ void CtStorageSqlite::_write_node_to_db(const CtTreeIter* ct_tree_iter,
             for (CtAnchoredWidget* pAnchoredWidget : ct_tree_iter->get_anchored_widgets(start_offset, end_offset)) {
                 if (not pAnchoredWidget->to_sqlite(_pDb, node_id, start_offset >= 0 ? -start_offset : 0, storage_cache))
                     throw std::runtime_error("couldn't save widget");
+                if (_ftsAvailable) {
+                    (void)pAnchoredWidget->visit_searchable_text([&fts_text](std::string_view text, const size_t, const size_t){
+                        fts_text += '\n';
+                        fts_text.append(text.data(), text.size());
+                        return false;
+                    });
+                }
                 switch (pAnchoredWidget->get_type()) {
                     case CtAnchWidgType::CodeBox: has_codebox = true; break;
                     case CtAnchWidgType::TableLight: [[fallthrough]];
@@ -859,6 +1226,18 @@ void CtStorageSqlite::_write_node_to_db(const CtTreeIter* ct_tree_iter,
                 throw std::runtime_error(ERR_SQLITE_STEP + sqlite3_errmsg(_pDb));
             }
         }
+        if (_ftsAvailable) {
+            if (is_richtxt & 0x01) {
+                // the anchored widgets are not part of the buffer text
+                const auto text_buffer = ct_tree_iter->get_node_text_buffer();
+                const Gtk::TextIter iter_end = end_offset < 0 ? text_buffer->end() : text_buffer->get_iter_at_offset(end_offset);
+                fts_text.insert(0u, text_buffer->get_text(text_buffer->get_iter_at_offset(std::max(start_offset, 0)), iter_end, true/*include_hidden_chars*/).raw());
+            }
+            else {
+                fts_text = node_txt;
+            }
+            _fts_write_node(node_id, fts_text, ct_tree_iter->get_node_modification_time());
+        }
     }
 }
 
@@ -887,6 +1266,9 @@ void CtStorageSqlite::_remove_db_node_with_children(const gint64 node_id)
     _exec_bind_int64(TABLE_IMAGE_DELETE, node_id);
     _exec_bind_int64(TABLE_NODE_DELETE, node_id);
     _exec_bind_int64(TABLE_CHILDREN_DELETE, node_id);
+    if (_ftsAvailable) {
+        _exec_bind_int64(TABLE_NODE_FTS_DELETE, node_id);
+    }
 
     for (const std::pair<gint64,gint64>& child_id_pair : _get_children_node_ids_from_db(node_id)) {
         _remove_db_node_with_children(child_id_pair.first);
@@ -31,6 +31,11 @@
 #include <gtkmm/treeiter.h>
 #include <unordered_set>
 
+// sqlite3_serialize and sqlite3_deserialize are built in by default since 3.36
+#if SQLITE_VERSION_NUMBER >= 3036000 && !defined(SQLITE_OMIT_DESERIALIZE)
+#define CT_SQLITE_SERIALIZE
+#endif // SQLITE_VERSION_NUMBER >= 3036000
+
 class CtMainWin;
 class CtAnchoredWidget;
 class CtTreeIter;
@@ -50,6 +55,9 @@ public:
     void try_reopen() override;
 
     bool populate_treestore(const fs::path& file_path, Glib::ustring& error) override;
+    bool structure_check(const fs::path& file_path, Glib::ustring& error) override;
+    bool structure_check_from_memory(const std::string_view data, Glib::ustring& error) override;
+    bool get_document_data(const fs::path& file_path, CtDocumentData& data) override;
     bool save_treestore(const fs::path& file_path,
                         const CtStorageSyncPending& syncPending,
                         Glib::ustring& error,
@@ -58,13 +66,19 @@ public:
                         const int start_offset = 0,
                         const int end_offset = -1) override;
     void vacuum() override;
+    bool backup_to(const fs::path& backup_path, Glib::ustring& error) override;
     void import_nodes(const fs::path& path, const Gtk::TreeIter& parent_iter) override;
 
     Glib::RefPtr<Gsv::Buffer> get_delayed_text_buffer(const gint64 node_id,
                                                       const std::string& syntax,
                                                       std::list<CtAnchoredWidget*>& widgets) const override;
+    bool get_delayed_raw_text(const gint64 node_id, CtStorageNodeRawText& raw_text) const override;
+    bool get_nodes_may_contain(const Glib::ustring& str_find,
+                               const bool match_case,
+                               std::unordered_set<gint64>& node_ids) const override;
 private:
     void _open_db(const fs::path& path);
+    void _open_db_from_memory(const std::string_view data);
     void _close_db();
     bool _check_database_integrity();
 
@@ -93,6 +107,11 @@ private:
     void                _table_from_db(const gint64& nodeId, std::list<CtAnchoredWidget*>& anchoredWidgets) const;
 
     void                _create_all_tables_in_db();
+    bool                _fts_table_exists();
+    bool                _fts_create_table();
+    void                _fts_fill_table();
+    void                _fts_write_node(const gint64 node_id, const std::string& fts_text, const gint64 ts_lastsave);
+    void                _fts_drop_table(const std::string& reason);
     void                _write_bookmarks_to_db(const std::list<gint64>& bookmarks);
     void                _write_node_to_db(const CtTreeIter* ct_tree_iter,
                                           const gint64 sequence,
@@ -107,10 +126,16 @@ private:
     std::list<std::pair<gint64,gint64>> _get_children_node_ids_from_db(const gint64 father_id);
     void                _remove_db_node_with_children(const gint64 node_id);
 
+    bool                _structure_check_db(Glib::ustring& error);
     void                _exec_no_callback(const char* sqlCmd);
     void                _exec_bind_int64(const char* sqlCmd, const gint64 bind_int64);
 
 public:
+    static const int BACKUP_STEP_PAGES{1024};
+    static const int BACKUP_BUSY_SLEEP_MS{20};
+    static const int BACKUP_BUSY_MAX_WAIT_MS{2000};
+    // above this size the document is not serialized in memory by get_document_data
+    const inline static std::uintmax_t SERIALIZE_MAX_SIZE{256u*1024u*1024u};
     static const char TABLE_NODE_CREATE[];
     static const char TABLE_NODE_INSERT[];
     static const char TABLE_NODE_DELETE[];
@@ -129,6 +154,9 @@ public:
     static const char TABLE_BOOKMARK_CREATE[];
     static const char TABLE_BOOKMARK_INSERT[];
     static const char TABLE_BOOKMARK_DELETE[];
+    static const char TABLE_NODE_FTS_CREATE[];
+    static const char TABLE_NODE_FTS_INSERT[];
+    static const char TABLE_NODE_FTS_DELETE[];
     static const Glib::ustring ERR_SQLITE_PREPV2;
     static const Glib::ustring ERR_SQLITE_STEP;
     static const char* safe_sqlite3_column_text(sqlite3_stmt* stmt, int iCol);
@@ -137,4 +165,5 @@ private:
     CtMainWin*    _pCtMainWin;
     sqlite3*      _pDb{nullptr};
     fs::path      _file_path;
+    bool          _ftsAvailable{false};
 };
@@ -0,0 +1,107 @@
+/*
+ * ct_storage_stats.cc
+ *
+ * Copyright 2009-2024
+ * Giuseppe Penone <giuspen@gmail.com>
+ * Evgenii Gurianov <https://github.com/txe>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "ct_storage_stats.h"
+#include "ct_logging.h"
+#include <algorithm>
+
+/*static*/bool CtStorageStats::_has(const Spans& spans, const std::string& phase)
+{
+    return std::any_of(spans.begin(), spans.end(), [&phase](const auto& span){ return span.first == phase; });
+}
+
+CtStorageStatsRecorder::Span::Span(CtStorageStatsRecorder* pRecorder, const Op op, const char* phase, const guint64 saveSeq/*= 0*/)
+ : _pRecorder{pRecorder}
+ , _op{op}
+ , _phase{phase}
+ , _saveSeq{saveSeq}
+ , _startUs{g_get_monotonic_time()}
+{
+}
+
+CtStorageStatsRecorder::Span::~Span()
+{
+    if (_pRecorder) {
+        _pRecorder->add_span(_op, _phase, (g_get_monotonic_time() - _startUs) / 1000.0, _saveSeq);
+    }
+}
+
+void CtStorageStatsRecorder::begin(const Op op, const std::string& backend)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.backend = backend;
+    if (Op::Load == op) {
+        _stats.loadSpans.clear();
+        _stats.nodesLoaded = 0;
+    }
+    else {
+        ++_saveSeq;
+        _stats.saveSpans.clear();
+        _stats.nodesWritten = 0;
+        _stats.imagesEncoded = 0;
+        _stats.bytesWritten = 0;
+    }
+}
+
+guint64 CtStorageStatsRecorder::get_save_seq() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _saveSeq;
+}
+
+void CtStorageStatsRecorder::add_span(const Op op, const char* phase, const double ms, const guint64 saveSeq/*= 0*/)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (Op::Save == op and 0u != saveSeq and saveSeq != _saveSeq) {
+        // late, the stats are already of a newer save
+        spdlog::debug("{} save#{} {} {:.1f} ms", _stats.backend, saveSeq, phase, ms);
+        return;
+    }
+    spdlog::debug("{} {} {} {:.1f} ms", _stats.backend, Op::Load == op ? "load" : "save", phase, ms);
+    (Op::Load == op ? _stats.loadSpans : _stats.saveSpans).emplace_back(phase, ms);
+}
+
+void CtStorageStatsRecorder::add_nodes(const Op op, const size_t num)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    (Op::Load == op ? _stats.nodesLoaded : _stats.nodesWritten) += num;
+}
+
+void CtStorageStatsRecorder::add_images_encoded(const size_t num)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.imagesEncoded += num;
+}
+
+void CtStorageStatsRecorder::set_bytes_written(const guint64 bytes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats.bytesWritten = bytes;
+    spdlog::debug("{} save {} bytes, {} nodes, {} images", _stats.backend, bytes, _stats.nodesWritten, _stats.imagesEncoded);
+}
+
+CtStorageStats CtStorageStatsRecorder::get() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
@@ -0,0 +1,92 @@
+/*
+ * ct_storage_stats.h
+ *
+ * Copyright 2009-2024
+ * Giuseppe Penone <giuspen@gmail.com>
+ * Evgenii Gurianov <https://github.com/txe>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <string>
+#include <vector>
+#include <mutex>
+
+/**
+ * @brief Timing and throughput of the latest load and of the latest save of a document
+ */
+struct CtStorageStats
+{
+    using Spans = std::vector<std::pair<std::string, double>>; // phase, milliseconds in order of completion
+
+    std::string backend;
+    Spans       loadSpans;
+    Spans       saveSpans;
+    size_t      nodesLoaded{0};
+    size_t      nodesWritten{0};
+    size_t      imagesEncoded{0};
+    guint64     bytesWritten{0};
+
+    bool has_save_span(const std::string& phase) const { return _has(saveSpans, phase); }
+    bool has_load_span(const std::string& phase) const { return _has(loadSpans, phase); }
+
+private:
+    static bool _has(const Spans& spans, const std::string& phase);
+};
+
+/**
+ * @brief Thread safe collector of CtStorageStats, fed by the storage control, the storage
+ * entities and the backup/encrypt thread; each span is also logged at debug level
+ */
+class CtStorageStatsRecorder
+{
+public:
+    enum class Op { Load, Save };
+
+    // times a phase from construction to destruction, a null recorder makes it a no-op;
+    // with a saveSeq the span is dropped if that save is no longer the latest one
+    class Span
+    {
+    public:
+        Span(CtStorageStatsRecorder* pRecorder, const Op op, const char* phase, const guint64 saveSeq = 0);
+        ~Span();
+    private:
+        CtStorageStatsRecorder* const _pRecorder;
+        const Op                      _op;
+        const char* const             _phase;
+        const guint64                 _saveSeq;
+        const gint64                  _startUs;
+    };
+
+    // starts over the spans and the counters of op
+    void begin(const Op op, const std::string& backend);
+    // of the latest save started, for the spans recorded later by another thread
+    guint64 get_save_seq() const;
+    void add_span(const Op op, const char* phase, const double ms, const guint64 saveSeq = 0);
+    void add_nodes(const Op op, const size_t num);
+    void add_images_encoded(const size_t num);
+    void set_bytes_written(const guint64 bytes);
+
+    CtStorageStats get() const;
+
+private:
+    mutable std::mutex _mutex;
+    CtStorageStats     _stats;
+    guint64            _saveSeq{0};
+};
@@ -31,9 +31,69 @@
 #include "ct_table.h"
 #include "ct_main_win.h"
 #include "ct_storage_control.h"
+#include "ct_storage_stats.h"
 #include "ct_storage_multifile.h"
 #include "ct_logging.h"
 
+bool CtStorageXml::get_document_data(const fs::path& file_path, CtDocumentData& data)
+{
+    // only what the latest save wrote, handed over once
+    if (not _pWrittenData or not *_pWrittenData or _writtenDataPath != file_path) {
+        return false;
+    }
+    data = std::move(*_pWrittenData);
+    _pWrittenData.reset();
+    return true;
+}
+
+bool CtStorageXml::structure_check(const fs::path& file_path, Glib::ustring& error)
+{
+    return _well_formed_check(xmlReaderForFile(file_path.c_str(), nullptr/*encoding*/, XML_PARSE_HUGE), error);
+}
+
+bool CtStorageXml::structure_check_from_memory(const std::string_view data, Glib::ustring& error)
+{
+    if (data.size() > static_cast<size_t>(G_MAXINT)) {
+        error = "xml too big";
+        return false;
+    }
+    return _well_formed_check(xmlReaderForMemory(data.data(), static_cast<int>(data.size()), nullptr/*URL*/, nullptr/*encoding*/, XML_PARSE_HUGE), error);
+}
+
+/*static*/bool CtStorageXml::_well_formed_check(xmlTextReaderPtr pReader, Glib::ustring& error)
+{
+    // streamed through, no tree built
+    if (not pReader) {
+        error = "xml reader fail";
+        return false;
+    }
+    bool rootChecked{false};
+    int ret;
+    while (1 == (ret = xmlTextReaderRead(pReader))) {
+        if (not rootChecked and XML_READER_TYPE_ELEMENT == xmlTextReaderNodeType(pReader)) {
+            if (0 != g_strcmp0(reinterpret_cast<const char*>(xmlTextReaderConstName(pReader)), CtConst::APP_NAME)) {
+                ret = -2;
+                break;
+            }
+            rootChecked = true;
+        }
+    }
+    xmlFreeTextReader(pReader);
+    if (-2 == ret) {
+        error = "document contains the wrong node root";
+        return false;
+    }
+    if (0 != ret) {
+        error = "xml parse fail";
+        return false;
+    }
+    if (not rootChecked) {
+        error = "document is null";
+        return false;
+    }
+    return true;
+}
+
 bool CtStorageXml::populate_treestore(const fs::path& file_path, Glib::ustring& error)
 {
     try {
@@ -97,6 +157,10 @@ bool CtStorageXml::populate_treestore(const fs::path& file_path, Glib::ustring&
             ct_tree_store.get_node_data(ctTreeIter, nodeData, false/*loadTextBuffer*/);
             ct_tree_store.update_node_data(ctTreeIter, nodeData);
         }
+        if (not _isDryRun) {
+            _contentIndexConn.disconnect(); // the idle indexing of a previous populate
+            _contentIndexConn = CtStorageXmlHelper::content_index_start(_delayed_text_buffers, _contentIndex);
+        }
         return true;
     }
     catch (std::exception& e) {
@@ -115,39 +179,106 @@ bool CtStorageXml::save_treestore(const fs::path& file_path,
 {
     try {
         xmlpp::Document xml_doc;
-        xml_doc.create_root_node(CtConst::APP_NAME);
-
-        if ( CtExporting::NONESAVE == export_type or
-             CtExporting::NONESAVEAS == export_type or
-             CtExporting::ALL_TREE == export_type )
-        {
-            // save bookmarks
-            xmlpp::Element* p_bookmarks_node = xml_doc.get_root_node()->add_child("bookmarks");
-            p_bookmarks_node->set_attribute("list", str::join_numbers(_pCtMainWin->get_tree_store().bookmarks_get(), ","));
-        }
-
-        CtStorageCache storage_cache;
-        storage_cache.generate_cache(_pCtMainWin, nullptr, true/*for_xml*/);
-
-        // save nodes
-        if ( CtExporting::NONESAVE == export_type or
-             CtExporting::NONESAVEAS == export_type or
-             CtExporting::ALL_TREE == export_type )
-        {
-            auto ct_tree_iter = _pCtMainWin->get_tree_store().get_ct_iter_first();
-            while (ct_tree_iter) {
-                _nodes_to_xml(&ct_tree_iter,
-                              xml_doc.get_root_node(),
-                              &storage_cache,
-                              export_type,
-                              pExpoMasterReassign,
-                              start_offset,
-                              end_offset);
-                ++ct_tree_iter;
+        _treestore_to_xml(xml_doc, export_type, pExpoMasterReassign, start_offset, end_offset);
+
+        // write file
+        CtStorageStatsRecorder::Span span{_pStatsRecorder, CtStorageStatsRecorder::Op::Save, "xml_format"};
+        _writtenDataPath = file_path;
+        _pWrittenData = _keepWrittenData ? std::make_shared<CtDocumentData>() : nullptr;
+        _write_xml_doc(xml_doc, file_path, _pWrittenData.get());
+
+        return true;
+    }
+    catch (std::exception& e) {
+        error = e.what();
+        return false;
+    }
+}
+
+std::function<bool(Glib::ustring&)> CtStorageXml::save_treestore_snapshot(const fs::path& file_path, Glib::ustring& error)
+{
+    try {
+        // the document is the snapshot, no longer tied to the tree once built; the images are
+        // taken as their pixbufs and encoded into it by the writing thread
+        auto pXmlDoc = std::make_shared<xmlpp::Document>();
+        auto pSnapshotCache = std::make_shared<CtStorageCache>();
+        pSnapshotCache->set_defer_images(true);
+        _treestore_to_xml(*pXmlDoc, CtExporting::NONESAVE, nullptr/*pExpoMasterReassign*/, 0/*start_offset*/, -1/*end_offset*/, pSnapshotCache.get());
+        // filled by the writing thread, read on the GTK thread once it is joined
+        _writtenDataPath = file_path;
+        _pWrittenData = _keepWrittenData ? std::make_shared<CtDocumentData>() : nullptr;
+        return [pXmlDoc, pSnapshotCache, file_path, pWrittenData=_pWrittenData, pStatsRecorder=_pStatsRecorder](Glib::ustring& write_error)->bool{
+            try {
+                {
+                    CtStorageStatsRecorder::Span span{pStatsRecorder, CtStorageStatsRecorder::Op::Save, "cache"};
+                    pSnapshotCache->encode_deferred_images();
+                }
+                CtStorageStatsRecorder::Span span{pStatsRecorder, CtStorageStatsRecorder::Op::Save, "xml_format"};
+                _write_xml_doc(*pXmlDoc, file_path, pWrittenData.get());
+                return true;
             }
-        }
-        else {
-            CtTreeIter ct_tree_iter = _pCtMainWin->curr_tree_iter();
+            catch (std::exception& e) {
+                write_error = e.what();
+                return false;
+            }
+        };
+    }
+    catch (std::exception& e) {
+        error = e.what();
+        return std::function<bool(Glib::ustring&)>{};
+    }
+}
+
+/*static*/void CtStorageXml::_write_xml_doc(xmlpp::Document& xml_doc, const fs::path& file_path, CtDocumentData* pWrittenData)
+{
+    if (not pWrittenData) {
+        xml_doc.write_to_file_formatted(file_path.string());
+        return;
+    }
+    // the very buffer written to disk is kept, no reading back of the file
+    auto pXml = std::make_shared<const Glib::ustring>(xml_doc.write_to_string_formatted());
+    GError* pError{nullptr};
+    if (not g_file_set_contents(file_path.c_str(), pXml->c_str(), static_cast<gssize>(pXml->bytes()), &pError)) {
+        const std::string error = pError ? pError->message : "g_file_set_contents";
+        g_clear_error(&pError);
+        throw std::runtime_error(error);
+    }
+    pWrittenData->bytes = std::shared_ptr<const char>{pXml, pXml->c_str()};
+    pWrittenData->size = pXml->bytes();
+}
+
+void CtStorageXml::_treestore_to_xml(xmlpp::Document& xml_doc,
+                                     const CtExporting export_type,
+                                     const std::map<gint64, gint64>* pExpoMasterReassign,
+                                     const int start_offset,
+                                     const int end_offset,
+                                     CtStorageCache* pSnapshotCache/*= nullptr*/)
+{
+    xml_doc.create_root_node(CtConst::APP_NAME);
+
+    if ( CtExporting::NONESAVE == export_type or
+         CtExporting::NONESAVEAS == export_type or
+         CtExporting::ALL_TREE == export_type )
+    {
+        // save bookmarks
+        xmlpp::Element* p_bookmarks_node = xml_doc.get_root_node()->add_child("bookmarks");
+        p_bookmarks_node->set_attribute("list", str::join_numbers(_pCtMainWin->get_tree_store().bookmarks_get(), ","));
+    }
+
+    CtStorageCache local_storage_cache;
+    if (not pSnapshotCache) {
+        local_storage_cache.generate_cache(_pCtMainWin, nullptr, true/*for_xml*/, _pStatsRecorder);
+    }
+    CtStorageCache& storage_cache = pSnapshotCache ? *pSnapshotCache : local_storage_cache;
+
+    // save nodes
+    CtStorageStatsRecorder::Span span{_pStatsRecorder, CtStorageStatsRecorder::Op::Save, "nodes"};
+    if ( CtExporting::NONESAVE == export_type or
+         CtExporting::NONESAVEAS == export_type or
+         CtExporting::ALL_TREE == export_type )
+    {
+        auto ct_tree_iter = _pCtMainWin->get_tree_store().get_ct_iter_first();
+        while (ct_tree_iter) {
             _nodes_to_xml(&ct_tree_iter,
                           xml_doc.get_root_node(),
                           &storage_cache,
@@ -155,16 +286,18 @@ bool CtStorageXml::save_treestore(const fs::path& file_path,
                           pExpoMasterReassign,
                           start_offset,
                           end_offset);
+            ++ct_tree_iter;
         }
-
-        // write file
-        xml_doc.write_to_file_formatted(file_path.string());
-
-        return true;
     }
-    catch (std::exception& e) {
-        error = e.what();
-        return false;
+    else {
+        CtTreeIter ct_tree_iter = _pCtMainWin->curr_tree_iter();
+        _nodes_to_xml(&ct_tree_iter,
+                      xml_doc.get_root_node(),
+                      &storage_cache,
+                      export_type,
+                      pExpoMasterReassign,
+                      start_offset,
+                      end_offset);
     }
 }
 
@@ -235,10 +368,32 @@ Glib::RefPtr<Gsv::Buffer> CtStorageXml::get_delayed_text_buffer(const gint64 nod
     auto ret_buffer = CtStorageXmlHelper{_pCtMainWin}.create_buffer_and_widgets_from_xml(xml_element, syntax, widgets, nullptr, -1, "");
     if (ret_buffer) {
         _delayed_text_buffers.erase(node_id);
+        _contentIndex.remove(node_id);
     }
     return ret_buffer;
 }
 
+bool CtStorageXml::get_delayed_raw_text(const gint64 node_id, CtStorageNodeRawText& raw_text) const
+{
+    const auto it = _delayed_text_buffers.find(node_id);
+    if (_delayed_text_buffers.end() == it) {
+        return false;
+    }
+    auto xml_element = dynamic_cast<xmlpp::Element*>(it->second->get_root_node()->get_first_child());
+    if (not xml_element) {
+        return false;
+    }
+    CtStorageXmlHelper::raw_text_from_xml(xml_element, raw_text);
+    return true;
+}
+
+bool CtStorageXml::get_nodes_may_contain(const Glib::ustring& str_find,
+                                          const bool/*match_case*/,
+                                          std::unordered_set<gint64>& node_ids) const
+{
+    return CtStorageXmlHelper::content_index_query(_delayed_text_buffers, _contentIndex, str_find, node_ids);
+}
+
 void CtStorageXml::_nodes_to_xml(CtTreeIter* ct_tree_iter,
                                  xmlpp::Element* p_node_parent,
                                  CtStorageCache* storage_cache,
@@ -247,6 +402,7 @@ void CtStorageXml::_nodes_to_xml(CtTreeIter* ct_tree_iter,
                                  const int start_offset/*= 0*/,
                                  const int end_offset/*= -1*/)
 {
+    if (_pStatsRecorder) _pStatsRecorder->add_nodes(CtStorageStatsRecorder::Op::Save, 1);
     Glib::RefPtr<Gsv::Buffer> rTextBuffer = ct_tree_iter->get_node_text_buffer();
     if (not rTextBuffer) {
         throw std::runtime_error(str::format(_("Failed to retrieve the content of the node '%s'"), ct_tree_iter->get_node_name()));
@@ -509,6 +665,98 @@ Glib::RefPtr<Gsv::Buffer> CtStorageXmlHelper::create_buffer_no_widgets(const Gli
     return Glib::RefPtr<Gsv::Buffer>{};
 }
 
+/*static*/void CtStorageXmlHelper::raw_text_from_xml(const xmlpp::Element* parent_xml_element, CtStorageNodeRawText& raw_text)
+{
+    for (const xmlpp::Node* xml_slot : parent_xml_element->get_children()) {
+        auto slot_element = dynamic_cast<const xmlpp::Element*>(xml_slot);
+        if (not slot_element) continue;
+        const Glib::ustring slot_element_name = slot_element->get_name();
+        if (slot_element_name == "rich_text") {
+            // the rich text slots concatenated are the text of the buffer
+            const xmlpp::TextNode* pTextNode = slot_element->get_child_text();
+            if (pTextNode) raw_text.text += pTextNode->get_content();
+        }
+        else if (slot_element_name == "codebox") {
+            const xmlpp::TextNode* pTextNode = slot_element->get_child_text();
+            raw_text.objects_text.push_back(pTextNode ? pTextNode->get_content() : "");
+        }
+        else if (slot_element_name == "table") {
+            raw_text_from_table_xml(slot_element, raw_text);
+        }
+        else if (slot_element_name == "encoded_png") {
+            const Glib::ustring anchorName = slot_element->get_attribute_value("anchor");
+            const Glib::ustring fileName = slot_element->get_attribute_value("filename");
+            if (not anchorName.empty()) {
+                raw_text.objects_text.push_back(anchorName);
+            }
+            else if (not fileName.empty() and fileName != CtImageLatex::LatexSpecialFilename) {
+                raw_text.objects_text.push_back(fileName);
+            }
+        }
+    }
+}
+
+/*static*/void CtStorageXmlHelper::raw_text_from_table_xml(const xmlpp::Element* table_xml_element, CtStorageNodeRawText& raw_text)
+{
+    for (const xmlpp::Node* pNodeRow : table_xml_element->get_children("row")) {
+        for (const xmlpp::Node* pNodeCell : pNodeRow->get_children("cell")) {
+            const xmlpp::TextNode* pTextNode = static_cast<const xmlpp::Element*>(pNodeCell)->get_child_text();
+            if (pTextNode) raw_text.objects_text.push_back(pTextNode->get_content());
+        }
+    }
+}
+
+/*static*/sigc::connection CtStorageXmlHelper::content_index_start(const CtDelayedTextBufferMap& delayed_text_buffers,
+                                                                  CtTrigramIndex& content_index)
+{
+    using CtDelayedNode = std::pair<gint64, std::shared_ptr<xmlpp::Document>>;
+    auto pPending = std::make_shared<std::list<CtDelayedNode>>(delayed_text_buffers.begin(), delayed_text_buffers.end());
+    return Glib::signal_idle().connect([&delayed_text_buffers, &content_index, pPending](){
+        // a few nodes at a time not to hold up the user interaction
+        for (int i = 0; i < 20 and not pPending->empty(); ++i) {
+            const CtDelayedNode delayedNode = pPending->front();
+            pPending->pop_front();
+            if (0u == delayed_text_buffers.count(delayedNode.first)) {
+                continue; // loaded in the meantime
+            }
+            auto xml_element = dynamic_cast<xmlpp::Element*>(delayedNode.second->get_root_node()->get_first_child());
+            if (not xml_element) {
+                continue;
+            }
+            CtStorageNodeRawText raw_text;
+            raw_text_from_xml(xml_element, raw_text);
+            for (const Glib::ustring& obj_text : raw_text.objects_text) {
+                raw_text.text += '\n';
+                raw_text.text += obj_text;
+            }
+            content_index.add(delayedNode.first, raw_text.text);
+        }
+        if (pPending->empty()) {
+            spdlog::debug("content index of {} nodes", content_index.size());
+            return false;
+        }
+        return true;
+    }, Glib::PRIORITY_LOW);
+}
+
+/*static*/bool CtStorageXmlHelper::content_index_query(const CtDelayedTextBufferMap& delayed_text_buffers,
+                                                     const CtTrigramIndex& content_index,
+                                                     const Glib::ustring& str_find,
+                                                     std::unordered_set<gint64>& node_ids)
+{
+    std::unordered_set<gint64> hits;
+    if (not content_index.query(str_find, hits)) {
+        return false;
+    }
+    // the nodes not yet indexed are unknown
+    for (const auto& delayedPair : delayed_text_buffers) {
+        if (not content_index.has(delayedPair.first) or hits.count(delayedPair.first)) {
+            node_ids.insert(delayedPair.first);
+        }
+    }
+    return true;
+}
+
 bool CtStorageXmlHelper::populate_table_matrix(CtTableMatrix& tableMatrix,
                                                const char* xml_content,
                                                CtTableColWidths& tableColWidths,
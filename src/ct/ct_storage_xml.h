@@ -24,11 +24,13 @@
 #pragma once
 
 #include "ct_types.h"
+#include "ct_trigram_index.h"
 #include "ct_filesystem.h"
 #include <glibmm/refptr.h>
 #include <gtksourceviewmm/buffer.h>
 #include <gtkmm/treeiter.h>
 #include <libxml++/libxml++.h>
+#include <libxml2/libxml/xmlreader.h>
 
 namespace xmlpp {
 
@@ -48,6 +50,7 @@ public:
     CtStorageXml(CtMainWin* pCtMainWin)
      : _pCtMainWin{pCtMainWin}
     {}
+    ~CtStorageXml() override { _contentIndexConn.disconnect(); }
 
     void close_connect() override {}
     void reopen_connect() override {}
@@ -58,6 +61,9 @@ public:
     static std::unique_ptr<xmlpp::DomParser> get_parser(const fs::path& file_path);
 
     bool populate_treestore(const fs::path& file_path, Glib::ustring& error) override;
+    bool get_document_data(const fs::path& file_path, CtDocumentData& data) override;
+    bool structure_check(const fs::path& file_path, Glib::ustring& error) override;
+    bool structure_check_from_memory(const std::string_view data, Glib::ustring& error) override;
     bool save_treestore(const fs::path& file_path,
                         const CtStorageSyncPending& syncPending,
                         Glib::ustring& error,
@@ -65,12 +71,25 @@ public:
                         const std::map<gint64, gint64>* pExpoMasterReassign = nullptr,
                         const int start_offset = 0,
                         const int end_offset = -1) override;
+    std::function<bool(Glib::ustring& error)> save_treestore_snapshot(const fs::path& file_path, Glib::ustring& error) override;
     void import_nodes(const fs::path& path, const Gtk::TreeIter& parent_iter) override;
 
     Glib::RefPtr<Gsv::Buffer> get_delayed_text_buffer(const gint64 node_id,
                                                       const std::string& syntax,
                                                       std::list<CtAnchoredWidget*>& widgets) const override;
+    bool get_delayed_raw_text(const gint64 node_id, CtStorageNodeRawText& raw_text) const override;
+    bool get_nodes_may_contain(const Glib::ustring& str_find,
+                               const bool match_case,
+                               std::unordered_set<gint64>& node_ids) const override;
 private:
+    static bool _well_formed_check(xmlTextReaderPtr pReader, Glib::ustring& error);
+    static void _write_xml_doc(xmlpp::Document& xml_doc, const fs::path& file_path, CtDocumentData* pWrittenData);
+    void _treestore_to_xml(xmlpp::Document& xml_doc,
+                           const CtExporting export_type,
+                           const std::map<gint64, gint64>* pExpoMasterReassign,
+                           const int start_offset,
+                           const int end_offset,
+                           CtStorageCache* pSnapshotCache = nullptr);
     void _nodes_to_xml(CtTreeIter* ct_tree_iter,
                        xmlpp::Element* p_node_parent,
                        CtStorageCache* storage_cache,
@@ -82,6 +101,10 @@ private:
 private:
     CtMainWin* const _pCtMainWin;
     mutable CtDelayedTextBufferMap _delayed_text_buffers;
+    mutable CtTrigramIndex _contentIndex;
+    sigc::connection _contentIndexConn;
+    fs::path _writtenDataPath;
+    std::shared_ptr<CtDocumentData> _pWrittenData; // of the latest save if _keepWrittenData
 };
 
 class CtStorageXmlHelper
@@ -125,6 +148,15 @@ public:
                                            const std::string& multifile_dir);
 
     Glib::RefPtr<Gsv::Buffer> create_buffer_no_widgets(const Glib::ustring& syntax, const char* xml_content);
+    static void raw_text_from_xml(const xmlpp::Element* parent_xml_element, CtStorageNodeRawText& raw_text);
+    static void raw_text_from_table_xml(const xmlpp::Element* table_xml_element, CtStorageNodeRawText& raw_text);
+    // index in idle time the content of the nodes not yet loaded
+    static sigc::connection content_index_start(const CtDelayedTextBufferMap& delayed_text_buffers,
+                                                CtTrigramIndex& content_index);
+    static bool content_index_query(const CtDelayedTextBufferMap& delayed_text_buffers,
+                                    const CtTrigramIndex& content_index,
+                                    const Glib::ustring& str_find,
+                                    std::unordered_set<gint64>& node_ids);
 
     bool populate_table_matrix(CtTableMatrix& tableMatrix,
                                const char* xml_content,
@@ -311,6 +311,19 @@ void CtTableHeavy::write_strings_matrix(std::vector<std::vector<Glib::ustring>>&
     }
 }
 
+bool CtTableHeavy::visit_searchable_text(const SearchableTextVisitor& f_visit) const
+{
+    for (size_t rowIdx = 0u; rowIdx < _tableMatrix.size(); ++rowIdx) {
+        for (size_t colIdx = 0u; colIdx < _tableMatrix[rowIdx].size(); ++colIdx) {
+            const auto f_view = [&f_visit, rowIdx, colIdx](std::string_view text){ return f_visit(text, rowIdx, colIdx); };
+            if (static_cast<CtTextCell*>(_tableMatrix[rowIdx][colIdx])->visit_text_content(f_view)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 void CtTableHeavy::_new_text_cell_attach(const size_t rowIdx, const size_t colIdx, CtTextCell* pTextCell)
 {
     CtTextView& textView = pTextCell->get_text_view();
@@ -141,6 +141,7 @@ public:
     std::shared_ptr<CtAnchoredWidgetState> get_state() override;
 
     void write_strings_matrix(std::vector<std::vector<Glib::ustring>>& rows) const override;
+    bool visit_searchable_text(const SearchableTextVisitor& f_visit) const override;
     size_t get_num_rows() const override { return _pListStore->children().size(); }
     size_t get_num_columns() const override { return _pColumns->columnsText.size(); }
 
@@ -199,6 +200,7 @@ public:
     CtTextView& curr_cell_text_view() const;
 
     void write_strings_matrix(std::vector<std::vector<Glib::ustring>>& rows) const override;
+    bool visit_searchable_text(const SearchableTextVisitor& f_visit) const override;
     size_t get_num_rows() const override { return _tableMatrix.size(); }
     size_t get_num_columns() const override { return _tableMatrix.front().size(); }
 
@@ -163,6 +163,29 @@ void CtTableLight::write_strings_matrix(std::vector<std::vector<Glib::ustring>>&
     _pListStore->foreach_iter(f_action);
 }
 
+bool CtTableLight::visit_searchable_text(const SearchableTextVisitor& f_visit) const
+{
+    // one cell at a time, the grid is not copied and the cell string is only viewed out of the GValue
+    const CtTableLightColumns& cols = get_columns();
+    const size_t numCols = get_num_columns();
+    GtkTreeModel* pTreeModel = GTK_TREE_MODEL(_pListStore->gobj());
+    size_t rowIdx{0u};
+    for (const Gtk::TreeRow& treeRow : _pListStore->children()) {
+        for (size_t colIdx = 0u; colIdx < numCols; ++colIdx) {
+            GValue value = G_VALUE_INIT;
+            gtk_tree_model_get_value(pTreeModel, const_cast<GtkTreeIter*>(treeRow.gobj()), cols.columnsText.at(colIdx).index(), &value);
+            const gchar* pText = g_value_get_string(&value);
+            const bool stop = f_visit(pText ? std::string_view{pText} : std::string_view{}, rowIdx, colIdx);
+            g_value_unset(&value);
+            if (stop) {
+                return true;
+            }
+        }
+        ++rowIdx;
+    }
+    return false;
+}
+
 void CtTableLight::_populate_xml_rows_cells(xmlpp::Element* p_table_node) const
 {
     // put header at the end
@@ -107,6 +107,8 @@ void CtTreeIter::set_node_id(const gint64 new_id)
 {
     if (*this) {
         (*this)->set_value(_pColumns->colNodeUniqueId, new_id);
+        _pCtMainWin->get_tree_store().hierarchical_names_cache_clear();
+        _pCtMainWin->get_tree_store().node_names_index_reset();
     }
     else {
         spdlog::error("!! {}", __FUNCTION__);
@@ -301,12 +303,24 @@ void CtTreeIter::set_node_name(const Glib::ustring& node_name)
             (*this)->set_value(_pColumns->colSharedNodesMasterId, static_cast<gint64>(0));
         }
         (*this)->set_value(_pColumns->colNodeName, node_name);
+        _pCtMainWin->get_tree_store().hierarchical_names_cache_clear(); // descendants embed this name too
+        _pCtMainWin->get_tree_store().node_names_index_update(*this);
     }
     else {
         spdlog::error("!! {}", __FUNCTION__);
     }
 }
 
+const std::vector<std::string>& CtTreeIter::get_node_hierarchical_names() const
+{
+    if (*this) {
+        return _pCtMainWin->get_tree_store().get_node_hierarchical_names(*this);
+    }
+    spdlog::error("!! {}", __FUNCTION__);
+    static const std::vector<std::string> noNames;
+    return noNames;
+}
+
 Glib::ustring CtTreeIter::get_node_tags() const
 {
     if (*this) {
@@ -706,6 +720,17 @@ CtTreeStore::CtTreeStore(CtMainWin* pCtMainWin)
  : _pCtMainWin{pCtMainWin}
 {
     _rTreeStore = Gtk::TreeStore::create(_columns);
+    // any structural change can move a node under different ancestors
+    _rTreeStore->signal_row_inserted().connect([this](const Gtk::TreeModel::Path&, const Gtk::TreeIter&){
+        hierarchical_names_cache_clear();
+    });
+    _rTreeStore->signal_row_deleted().connect([this](const Gtk::TreeModel::Path&){
+        hierarchical_names_cache_clear();
+        _nodeNamesIndexPurgeNeeded = true; // the ids of the deleted rows are unknown here
+    });
+    _rTreeStore->signal_rows_reordered().connect([this](const Gtk::TreeModel::Path&, const Gtk::TreeIter&, int*){
+        hierarchical_names_cache_clear();
+    });
 }
 
 CtTreeStore::~CtTreeStore()
@@ -716,6 +741,64 @@ CtTreeStore::~CtTreeStore()
     }
 }
 
+const std::vector<std::string>& CtTreeStore::get_node_hierarchical_names(const CtTreeIter& treeIter)
+{
+    const gint64 nodeId = treeIter.get_node_id();
+    const auto it = _hierarchicalNamesCache.find(nodeId);
+    if (it != _hierarchicalNamesCache.end()) {
+        return it->second;
+    }
+    std::vector<std::string> names;
+    CtTreeIter fatherIter = treeIter.parent();
+    if (fatherIter) {
+        names = get_node_hierarchical_names(fatherIter);
+    }
+    names.push_back(str::trim(treeIter.get_node_name()));
+    return _hierarchicalNamesCache.emplace(nodeId, std::move(names)).first->second;
+}
+
+std::vector<gint64> CtTreeStore::node_names_quick_find(const Glib::ustring& filter, const size_t maxResults)
+{
+    if (not _nodeNamesIndexOn) {
+        _nodeNamesIndexOn = true;
+        _nodeNamesIndexPurgeNeeded = false;
+        for (Gtk::TreeIter treeIter : _rTreeStore->children()) {
+            node_names_index_update(treeIter);
+        }
+    }
+    else if (_nodeNamesIndexPurgeNeeded) {
+        _nodeNamesIndexPurgeNeeded = false;
+        std::unordered_set<gint64> nodeIds;
+        _rTreeStore->foreach_iter([&nodeIds, this](const Gtk::TreeIter& iter) {
+            nodeIds.insert(iter->get_value(_columns.colNodeUniqueId));
+            return false; /* continue */
+        });
+        _nodeNamesIndex.retain(nodeIds);
+    }
+    return _nodeNamesIndex.find(filter, maxResults);
+}
+
+void CtTreeStore::node_names_index_update(const Gtk::TreeIter& treeIter)
+{
+    if (not _nodeNamesIndexOn) {
+        return;
+    }
+    // the paths of the descendants include this node name
+    CtTreeIter ctTreeIter = to_ct_tree_iter(treeIter);
+    _nodeNamesIndex.set(ctTreeIter.get_node_id(),
+                        ctTreeIter.get_node_name(),
+                        str::join(ctTreeIter.get_node_hierarchical_names(), " / "));
+    for (Gtk::TreeIter childIter : treeIter->children()) {
+        node_names_index_update(childIter);
+    }
+}
+
+void CtTreeStore::node_names_index_reset()
+{
+    _nodeNamesIndexOn = false;
+    _nodeNamesIndex.clear();
+}
+
 void CtTreeStore::pending_rm_db_nodes(const std::vector<gint64>& node_ids)
 {
     _pCtMainWin->get_ct_storage()->pending_rm_db_nodes(node_ids);
@@ -771,41 +854,64 @@ void CtTreeStore::treeview_set_tree_path_n_text_cursor(CtTreeView* pTreeView,
 
 std::string CtTreeStore::treeview_get_tree_expanded_collapsed_string(Gtk::TreeView& treeView)
 {
-    std::vector<std::string> expanded_collapsed_vec;
-    _rTreeStore->foreach(
-        [this, &treeView, &expanded_collapsed_vec](const Gtk::TreePath& path, const Gtk::TreeIter& iter)->bool{
-            expanded_collapsed_vec.push_back(std::to_string(iter->get_value(_columns.colNodeUniqueId))
-                                             + ","
-                                             + (treeView.row_expanded(path) ? "True" : "False"));
-            return false; /* false for continue */
-        }
-    );
-    return str::join(expanded_collapsed_vec, "_");
+    // only the expanded nodes, parents before children; the rows under a collapsed one are not visited
+    std::string expanded_string;
+    treeView.map_expanded_rows([this, &expanded_string](Gtk::TreeView*, const Gtk::TreePath& path){
+        if (not expanded_string.empty()) expanded_string += "_";
+        expanded_string += std::to_string(_rTreeStore->get_iter(path)->get_value(_columns.colNodeUniqueId));
+    });
+    return expanded_string;
 }
 
 void CtTreeStore::treeview_set_tree_expanded_collapsed_string(const std::string& expanded_collapsed_string, Gtk::TreeView& treeView, bool nodes_bookm_exp)
 {
-    std::map<gint64, bool> expanded_collapsed_dict;
-    auto expand_collapsed_vec = str::split(expanded_collapsed_string, "_");
-    for (const std::string& element: expand_collapsed_vec) {
-        auto couple = str::split(element, ",");
-        if (couple.size() == 2) {
-            expanded_collapsed_dict[std::stoll(couple[0])] = CtStrUtil::is_str_true(couple[1]);
+    // "id_id_..." of the expanded nodes, or the former "id,True_id,False_..." of all the nodes
+    std::vector<gint64> expanded_ids;
+    for (const std::string& element : str::split(expanded_collapsed_string, "_")) {
+        const size_t commaPos = element.find(',');
+        if (std::string::npos == commaPos) {
+            if (not element.empty()) {
+                expanded_ids.push_back(std::stoll(element));
+            }
+        }
+        else if (CtStrUtil::is_str_true(element.substr(commaPos+1))) {
+            expanded_ids.push_back(std::stoll(element.substr(0, commaPos)));
         }
     }
-    treeView.collapse_all();
-    _rTreeStore->foreach(
-        [this, &treeView, &expanded_collapsed_dict, &nodes_bookm_exp](const Gtk::TreePath& path, const Gtk::TreeIter& iter)->bool{
-            gint64 node_id = iter->get_value(_columns.colNodeUniqueId);
-            if (map::exists(expanded_collapsed_dict, node_id) and expanded_collapsed_dict.at(node_id)) {
-                treeView.expand_row(path, false);
+    std::unordered_map<gint64, Gtk::TreeIter> iters_to_expand;
+    for (const gint64 node_id : expanded_ids) {
+        iters_to_expand[node_id] = Gtk::TreeIter{};
+    }
+    std::unordered_set<gint64> bookmarked_ids;
+    if (nodes_bookm_exp) {
+        bookmarked_ids.insert(_bookmarks.begin(), _bookmarks.end());
+    }
+    std::vector<Gtk::TreeIter> bookmarks_iters;
+    if (not iters_to_expand.empty() or not bookmarked_ids.empty()) {
+        // a single walk of the model to resolve the ids, no view involved
+        _rTreeStore->foreach_iter([&](const Gtk::TreeIter& iter)->bool{
+            const gint64 node_id = iter->get_value(_columns.colNodeUniqueId);
+            const auto it = iters_to_expand.find(node_id);
+            if (iters_to_expand.end() != it) {
+                it->second = iter;
             }
-            else if (nodes_bookm_exp and vec::exists(_bookmarks, node_id) and iter->parent()) {
-                treeView.expand_to_path(_rTreeStore->get_path(iter->parent()));
+            if (bookmarked_ids.count(node_id) and iter->parent()) {
+                bookmarks_iters.push_back(iter->parent());
             }
             return false; /* false for continue */
+        });
+    }
+    treeView.collapse_all();
+    // the parents come first so that each row is expanded once
+    for (const gint64 node_id : expanded_ids) {
+        const Gtk::TreeIter& iter = iters_to_expand.at(node_id);
+        if (iter) {
+            treeView.expand_row(_rTreeStore->get_path(iter), false);
         }
-    );
+    }
+    for (const Gtk::TreeIter& iter : bookmarks_iters) {
+        treeView.expand_to_path(_rTreeStore->get_path(iter));
+    }
 }
 
 void CtTreeStore::tree_view_connect(Gtk::TreeView* pTreeView)
@@ -997,6 +1103,7 @@ void CtTreeStore::update_node_data(const Gtk::TreeIter& treeIter, const CtNodeDa
 
     row[_columns.rColPixbuf] = _get_node_icon(_rTreeStore->iter_depth(treeIter), nodeData.syntax, nodeData.customIconId);
     row[_columns.colNodeName] = nodeData.name;
+    hierarchical_names_cache_clear();
     row[_columns.rColTextBuffer] = nodeData.rTextBuffer;
     row[_columns.colSyntaxHighlighting] = nodeData.syntax;
     row[_columns.colNodeTags] = nodeData.tags;
@@ -1009,6 +1116,7 @@ void CtTreeStore::update_node_data(const Gtk::TreeIter& treeIter, const CtNodeDa
     row[_columns.colTsCreation] = nodeData.tsCreation;
     row[_columns.colTsLastSave] = nodeData.tsLastSave;
     row[_columns.colAnchoredWidgets] = nodeData.anchoredWidgets;
+    node_names_index_update(treeIter);
 
     update_node_aux_icon(treeIter);
     add_used_tags(nodeData.tags);
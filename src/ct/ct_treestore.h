@@ -24,6 +24,7 @@
 #pragma once
 
 #include "ct_types.h"
+#include "ct_trigram_index.h"
 #include <gtkmm.h>
 #include <gtksourceviewmm.h>
 #include <set>
@@ -111,6 +112,7 @@ public:
     guint16       get_node_custom_icon_id() const;
     Glib::ustring get_node_name() const;
     void          set_node_name(const Glib::ustring& node_name);
+    const std::vector<std::string>& get_node_hierarchical_names() const;
     Glib::ustring get_node_tags() const;
     std::string   get_node_foreground() const;
     std::string   get_node_syntax_highlighting() const;
@@ -192,6 +194,15 @@ public:
     CtTreeIter                     get_node_from_node_id(const gint64 node_id);
     CtTreeIter                     get_node_from_node_name(const Glib::ustring& node_name);
 
+    // trimmed names from the root down to treeIter, cached per node id until a rename or structural change
+    const std::vector<std::string>& get_node_hierarchical_names(const CtTreeIter& treeIter);
+    void                           hierarchical_names_cache_clear() { _hierarchicalNamesCache.clear(); }
+
+    // node ids ranked by name/path match, the index is built on first use and then kept up to date
+    std::vector<gint64>            node_names_quick_find(const Glib::ustring& filter, const size_t maxResults);
+    void                           node_names_index_update(const Gtk::TreeIter& treeIter);
+    void                           node_names_index_reset();
+
     bool                           bookmarks_add(gint64 nodeId);
     bool                           bookmarks_remove(gint64 nodeId);
     const std::list<gint64>&       bookmarks_get();
@@ -228,6 +239,10 @@ private:
     std::list<gint64>               _bookmarks;
     std::set<Glib::ustring>         _usedTags;
     std::map<gint64, Glib::ustring> _nodes_names_dict; // for link tooltips
+    std::unordered_map<gint64, std::vector<std::string>> _hierarchicalNamesCache;
+    CtNodeNamesIndex                _nodeNamesIndex;
+    bool                            _nodeNamesIndexOn{false};
+    bool                            _nodeNamesIndexPurgeNeeded{false};
     std::list<sigc::connection>     _curr_node_sigc_conn;
     CtMainWin*                      _pCtMainWin;
 };
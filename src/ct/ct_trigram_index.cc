@@ -0,0 +1,222 @@
+/*
+ * ct_trigram_index.cc
+ *
+ * Copyright 2009-2024
+ * Giuseppe Penone <giuspen@gmail.com>
+ * Evgenii Gurianov <https://github.com/txe>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#include "ct_trigram_index.h"
+#include <algorithm>
+#include <tuple>
+
+namespace {
+
+gunichar _fold(const gunichar ch)
+{
+    // upper then lower to meet the caseless regex also on characters like the long s
+    return g_unichar_tolower(g_unichar_toupper(ch));
+}
+
+} // namespace (anonymous)
+
+/*static*/std::vector<guint64> CtTrigramIndex::get_trigrams(const Glib::ustring& text)
+{
+    std::vector<guint64> trigrams;
+    guint64 window{0};
+    size_t num_chars{0};
+    for (const gunichar ch : text) {
+        // 21 bits are enough for any unicode code point
+        window = ((window << 21) | _fold(ch)) & 0x7fffffffffffffffull;
+        if (++num_chars >= 3u) {
+            trigrams.push_back(window);
+        }
+    }
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+void CtTrigramIndex::add(const gint64 id, const Glib::ustring& text)
+{
+    remove(id);
+    std::vector<guint64> trigrams = get_trigrams(text);
+    for (const guint64 trigram : trigrams) {
+        _postings[trigram].push_back(id);
+    }
+    _idTrigrams[id] = std::move(trigrams);
+}
+
+void CtTrigramIndex::remove(const gint64 id)
+{
+    const auto it = _idTrigrams.find(id);
+    if (_idTrigrams.end() == it) {
+        return;
+    }
+    for (const guint64 trigram : it->second) {
+        auto itPosting = _postings.find(trigram);
+        if (_postings.end() == itPosting) continue;
+        std::vector<gint64>& ids = itPosting->second;
+        ids.erase(std::remove(ids.begin(), ids.end(), id), ids.end());
+        if (ids.empty()) {
+            _postings.erase(itPosting);
+        }
+    }
+    _idTrigrams.erase(it);
+}
+
+void CtTrigramIndex::clear()
+{
+    _postings.clear();
+    _idTrigrams.clear();
+}
+
+bool CtTrigramIndex::query(const Glib::ustring& str_find, std::unordered_set<gint64>& ids) const
+{
+    const std::vector<guint64> trigrams = get_trigrams(str_find);
+    if (trigrams.empty()) {
+        return false;
+    }
+    // start from the rarest trigram and intersect with the others
+    std::vector<const std::vector<gint64>*> postings;
+    for (const guint64 trigram : trigrams) {
+        const auto it = _postings.find(trigram);
+        if (_postings.end() == it) {
+            return true; // no id contains this trigram
+        }
+        postings.push_back(&it->second);
+    }
+    std::sort(postings.begin(), postings.end(), [](const std::vector<gint64>* a, const std::vector<gint64>* b){
+        return a->size() < b->size();
+    });
+    std::unordered_set<gint64> result{postings.front()->begin(), postings.front()->end()};
+    for (size_t i = 1; i < postings.size() and not result.empty(); ++i) {
+        const std::unordered_set<gint64> other{postings[i]->begin(), postings[i]->end()};
+        for (auto it = result.begin(); it != result.end(); ) {
+            if (other.count(*it)) ++it;
+            else it = result.erase(it);
+        }
+    }
+    ids.insert(result.begin(), result.end());
+    return true;
+}
+
+void CtTrigramIndex::query_shared(const std::vector<guint64>& trigrams, const size_t min_shared, std::unordered_map<gint64, size_t>& shared) const
+{
+    std::unordered_map<gint64, size_t> counts;
+    for (const guint64 trigram : trigrams) {
+        const auto it = _postings.find(trigram);
+        if (_postings.end() == it) continue;
+        for (const gint64 id : it->second) {
+            ++counts[id];
+        }
+    }
+    for (const auto& [id, count] : counts) {
+        if (count >= min_shared) {
+            shared[id] = count;
+        }
+    }
+}
+
+/*static*/std::string CtNodeNamesIndex::fold(const Glib::ustring& text)
+{
+    std::string folded;
+    folded.reserve(text.bytes());
+    gchar utf8buf[6];
+    for (const gunichar ch : text) {
+        folded.append(utf8buf, g_unichar_to_utf8(_fold(ch), utf8buf));
+    }
+    return folded;
+}
+
+void CtNodeNamesIndex::set(const gint64 node_id, const Glib::ustring& name, const Glib::ustring& path)
+{
+    _entries[node_id] = Entry{fold(name), fold(path)};
+    _pathsIndex.add(node_id, path);
+}
+
+void CtNodeNamesIndex::remove(const gint64 node_id)
+{
+    _entries.erase(node_id);
+    _pathsIndex.remove(node_id);
+}
+
+void CtNodeNamesIndex::retain(const std::unordered_set<gint64>& node_ids)
+{
+    for (auto it = _entries.begin(); it != _entries.end(); ) {
+        if (node_ids.count(it->first)) {
+            ++it;
+        }
+        else {
+            _pathsIndex.remove(it->first);
+            it = _entries.erase(it);
+        }
+    }
+}
+
+void CtNodeNamesIndex::clear()
+{
+    _entries.clear();
+    _pathsIndex.clear();
+}
+
+std::vector<gint64> CtNodeNamesIndex::find(const Glib::ustring& filter, const size_t max_results) const
+{
+    const std::string folded_filter = fold(filter);
+    if (folded_filter.empty() or 0u == max_results) {
+        return {};
+    }
+    // (tier, shared trigrams, path length, node id), the lower the better
+    using Rank = std::tuple<int, long, size_t, gint64>;
+    std::vector<Rank> ranks;
+    auto f_rank = [&](const gint64 node_id, const Entry& entry, const size_t shared, const bool fuzzy_ok) {
+        int tier;
+        if (0 == entry.name.compare(0, folded_filter.size(), folded_filter)) tier = 0;
+        else if (entry.name.find(folded_filter) != std::string::npos) tier = 1;
+        else if (entry.path.find(folded_filter) != std::string::npos) tier = 2;
+        else if (fuzzy_ok) tier = 3;
+        else return;
+        ranks.emplace_back(tier, -static_cast<long>(shared), entry.path.size(), node_id);
+    };
+
+    const std::vector<guint64> trigrams = CtTrigramIndex::get_trigrams(filter);
+    if (trigrams.empty()) {
+        // too short for the trigrams, the entries are scanned
+        for (const auto& [node_id, entry] : _entries) {
+            f_rank(node_id, entry, 0u, false/*fuzzy_ok*/);
+        }
+    }
+    else {
+        std::unordered_map<gint64, size_t> shared;
+        _pathsIndex.query_shared(trigrams, (trigrams.size() + 1u) / 2u, shared);
+        for (const auto& [node_id, num_shared] : shared) {
+            const auto it = _entries.find(node_id);
+            if (_entries.end() != it) {
+                f_rank(node_id, it->second, num_shared, true/*fuzzy_ok*/);
+            }
+        }
+    }
+    const size_t num_results = std::min(max_results, ranks.size());
+    std::partial_sort(ranks.begin(), ranks.begin() + num_results, ranks.end());
+    std::vector<gint64> node_ids;
+    node_ids.reserve(num_results);
+    for (size_t i = 0; i < num_results; ++i) {
+        node_ids.push_back(std::get<3>(ranks[i]));
+    }
+    return node_ids;
+}
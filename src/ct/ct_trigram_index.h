@@ -0,0 +1,98 @@
+/*
+ * ct_trigram_index.h
+ *
+ * Copyright 2009-2024
+ * Giuseppe Penone <giuspen@gmail.com>
+ * Evgenii Gurianov <https://github.com/txe>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include <glibmm/ustring.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @brief In-memory inverted index of the text trigrams by id
+ * The characters are case folded so that a query answers for both case sensitive
+ * and insensitive searches. A query returns a superset of the ids whose text
+ * contains the given string, ids never added are unknown to the index and must
+ * be handled by the caller.
+ */
+class CtTrigramIndex
+{
+public:
+    void add(const gint64 id, const Glib::ustring& text);
+    void remove(const gint64 id);
+    void clear();
+
+    bool has(const gint64 id) const { return _idTrigrams.count(id) != 0; }
+    size_t size() const { return _idTrigrams.size(); }
+
+    /**
+     * @brief Get the ids whose text may contain str_find
+     * @return false if the string is too short to be answered from the index
+     */
+    bool query(const Glib::ustring& str_find, std::unordered_set<gint64>& ids) const;
+
+    /**
+     * @brief Count the trigrams shared with the given ones, for the ids sharing at least min_shared
+     */
+    void query_shared(const std::vector<guint64>& trigrams, const size_t min_shared, std::unordered_map<gint64, size_t>& shared) const;
+
+    static std::vector<guint64> get_trigrams(const Glib::ustring& text);
+
+private:
+    std::unordered_map<guint64, std::vector<gint64>> _postings;
+    std::unordered_map<gint64, std::vector<guint64>> _idTrigrams;
+};
+
+/**
+ * @brief Case folded names and hierarchical paths of the nodes by node id, for the ranked
+ * quick jump to a node: the filters of at least three characters are answered through
+ * the trigrams of the paths, tolerating up to half of the filter trigrams missing
+ */
+class CtNodeNamesIndex
+{
+public:
+    void set(const gint64 node_id, const Glib::ustring& name, const Glib::ustring& path);
+    void remove(const gint64 node_id);
+    void retain(const std::unordered_set<gint64>& node_ids);
+    void clear();
+
+    bool has(const gint64 node_id) const { return _entries.count(node_id) != 0; }
+    size_t size() const { return _entries.size(); }
+
+    /**
+     * @brief Get up to max_results node ids, best first: name starting with the filter,
+     * name containing it, path containing it, then the fuzzy matches by shared trigrams
+     */
+    std::vector<gint64> find(const Glib::ustring& filter, const size_t max_results) const;
+
+    static std::string fold(const Glib::ustring& text);
+
+private:
+    struct Entry
+    {
+        std::string name;
+        std::string path;
+    };
+    std::unordered_map<gint64, Entry> _entries;
+    CtTrigramIndex _pathsIndex;
+};
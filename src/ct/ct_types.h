@@ -24,6 +24,8 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <memory>
 #include <list>
 #include <set>
 #include <unordered_map>
@@ -32,8 +34,10 @@
 #include <optional>
 #include <condition_variable>
 #include <type_traits>
+#include <functional>
 #include <glibmm/ustring.h>
 #include <gtksourceviewmm/buffer.h>
+#include <gtkmm/treeiter.h>
 #include "ct_const.h"
 
 namespace fs {
@@ -270,6 +274,15 @@ struct CtStorageSyncPending
     std::unordered_set<gint64>                     nodes_to_rm_set;
 };
 
+// a whole document in memory, the bytes released by their owner with the last copy
+struct CtDocumentData
+{
+    std::shared_ptr<const char> bytes;
+    size_t                      size{0};
+    explicit operator bool() const { return static_cast<bool>(bytes); }
+    std::string_view view() const { return std::string_view{bytes.get(), size}; }
+};
+
 enum class CtBackupType { None, SingleFile, MultiFile };
 struct CtBackupEncryptData
 {
@@ -279,11 +292,22 @@ struct CtBackupEncryptData
     std::string file_path;
     std::string password;
     std::string extracted_copy;
+    CtDocumentData extracted_data; // in place of extracted_copy, archived from memory
+    std::string extracted_name;    // archive item name of extracted_data
+    guint64 saveSeq{0};            // of the save stats the job belongs to
+};
+
+// searchable content of a node as stored, read without creating the text buffer and widgets
+struct CtStorageNodeRawText
+{
+    Glib::ustring              text;         // node text, anchored widgets excluded
+    std::vector<Glib::ustring> objects_text; // codeboxes text, tables cells, anchors and embedded files names
 };
 
 struct CtNodeData;
 class CtAnchoredWidget;
 namespace Gtk { class TreeIter; }
+class CtStorageStatsRecorder;
 class CtStorageEntity
 {
 public:
@@ -296,6 +320,10 @@ public:
     virtual void try_reopen() = 0;
 
     virtual bool populate_treestore(const fs::path& file_path, Glib::ustring& error) = 0;
+    // checks the structure of the stored document, cheaper than a dry run of populate_treestore if overridden
+    virtual bool structure_check(const fs::path& file_path, Glib::ustring& error) { return populate_treestore(file_path, error); }
+    // as structure_check on the document held in data, false with error if not supported
+    virtual bool structure_check_from_memory(const std::string_view/*data*/, Glib::ustring& error) { error = "not supported"; return false; }
     virtual bool save_treestore(const fs::path& file_path,
                                 const CtStorageSyncPending& syncPending,
                                 Glib::ustring& error,
@@ -303,17 +331,36 @@ public:
                                 const std::map<gint64, gint64>* pExpoMasterReassign = nullptr,
                                 const int start_offset = 0,
                                 const int end_offset = -1) = 0;
+    // builds on the GTK thread a snapshot of the tree to save, returns the writing of it that can run on
+    // any thread; empty if the storage writes while reading the tree (or on error, then set)
+    virtual std::function<bool(Glib::ustring& error)> save_treestore_snapshot(const fs::path&/*file_path*/,
+                                                                              Glib::ustring&/*error*/) { return {}; }
     virtual void vacuum() = 0;
+    // the whole document saved at file_path without reading it back from disk, false if not supported or on error
+    virtual bool get_document_data(const fs::path&/*file_path*/, CtDocumentData&/*data*/) { return false; }
+    // copies the document into backup_path keeping the connection open, false if not supported or on error
+    virtual bool backup_to(const fs::path&/*backup_path*/, Glib::ustring&/*error*/) { return false; }
     virtual void import_nodes(const fs::path& path, const Gtk::TreeIter& parent_iter) = 0;
 
     virtual Glib::RefPtr<Gsv::Buffer> get_delayed_text_buffer(const gint64 node_id,
                                                               const std::string& syntax,
                                                               std::list<CtAnchoredWidget*>& widgets) const = 0;
+    // false if the node content is not available without loading the text buffer
+    virtual bool get_delayed_raw_text(const gint64 node_id, CtStorageNodeRawText& raw_text) const = 0;
+    // false if there is no content index, else the ids of the stored nodes that may contain str_find
+    virtual bool get_nodes_may_contain(const Glib::ustring&/*str_find*/,
+                                       const bool/*match_case*/,
+                                       std::unordered_set<gint64>&/*node_ids*/) const { return false; }
 
     void set_is_dry_run() { _isDryRun = true; }
+    void set_stats_recorder(CtStorageStatsRecorder* pStatsRecorder) { _pStatsRecorder = pStatsRecorder; }
+    // the next saves keep in memory what they write, for get_document_data
+    void set_keep_written_data(const bool keep) { _keepWrittenData = keep; }
 
 protected:
     bool _isDryRun{false};
+    bool _keepWrittenData{false};
+    CtStorageStatsRecorder* _pStatsRecorder{nullptr};
 };
 
 struct CtStockIcon
@@ -368,6 +415,28 @@ public:
             c.notify_one();
         }
     }
+    // the queued elements for which f_superseded(t, queued) is true are taken out and returned,
+    // f_superseded may let t take over part of them; if still full, waits for room rather than dropping t:
+    // the caller is blocked until the consumer pops an element, with no timeout
+    template<class F> std::list<T> push_back_coalesce(T t, F f_superseded) {
+        std::list<T> superseded;
+        std::unique_lock<std::mutex> lock(m);
+        for (auto it = q.begin(); it != q.end();) {
+            if (f_superseded(t, *it)) {
+                superseded.push_back(std::move(*it));
+                it = q.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+        while (q.size() >= MAX) {
+            cNotFull.wait(lock);
+        }
+        q.push_back(std::move(t));
+        c.notify_one();
+        return superseded;
+    }
     T pop_front() {
         std::unique_lock<std::mutex> lock(m);
         while (q.empty()) {
@@ -375,6 +444,7 @@ public:
         }
         T val = q.front();
         q.pop_front();
+        cNotFull.notify_one();
         return val;
     }
     std::optional<T> peek() const {
@@ -396,12 +466,14 @@ public:
     void clear() {
         std::lock_guard<std::mutex> lock(m);
         q.clear();
+        cNotFull.notify_all();
     }
 
 private:
     std::deque<T> q{};
     mutable std::mutex m{};
     std::condition_variable c{};
+    std::condition_variable cNotFull{};
 };
 
 struct CtSearchOptions {
@@ -450,6 +522,9 @@ struct CtSearchState {
 
     int            matches_num;
     bool           all_matches_first_in_node{false};
+    std::unordered_map<gint64, bool> content_candidates; // node id -> content may match
+    std::optional<std::unordered_set<gint64>> index_candidates; // from the storage content index, if any
+    std::unordered_map<gint64, Glib::RefPtr<Gtk::TextBuffer>> replaced_nodes; // replace all, node id -> buffer in a user action (not rich text) to finalise at the end
 
     std::unique_ptr<Gtk::Dialog> iteratedfinddialog;
     int            iterDialogPos[2]{-1,-1};
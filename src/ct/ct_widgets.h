@@ -31,6 +31,8 @@
 
 #include <unordered_map>
 #include <memory>
+#include <functional>
+#include <string_view>
 
 class CtMDParser;
 class CtClipboard;
@@ -68,6 +70,11 @@ public:
     virtual CtAnchWidgType get_type() const = 0;
     virtual std::shared_ptr<CtAnchoredWidgetState> get_state() = 0;
 
+    // passes the searchable text to f_visit, a table cell by cell, until f_visit returns true (then returns true)
+    // the text is a view valid only for the duration of the call
+    using SearchableTextVisitor = std::function<bool(std::string_view text, const size_t rowIdx, const size_t colIdx)>;
+    virtual bool visit_searchable_text(const SearchableTextVisitor& /*f_visit*/) const { return false; }
+
     void updateOffset(int charOffset) { _charOffset = charOffset; }
     void updateJustification(const std::string& justification) { _justification = justification; }
     void updateJustification(const Gtk::TextIter& textIter);
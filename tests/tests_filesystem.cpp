@@ -205,6 +205,23 @@ TEST(FileSystemGroup, move)
     ASSERT_EQ(3, fs::remove_all(test_dir_path2));
 }
 
+TEST(FileSystemGroup, clone)
+{
+    fs::path test_file_path = fs::path{UT::unitTestsDataDir} / fs::path{"test_clone.txt"};
+    fs::path test_file_path_clone = fs::path{UT::unitTestsDataDir} / fs::path{"test_clone_bis.txt"};
+    Glib::file_set_contents(test_file_path.string(), "blabla");
+    // an existing destination is overwritten
+    Glib::file_set_contents(test_file_path_clone.string(), "previous longer content");
+
+    ASSERT_TRUE(fs::clone_file(test_file_path, test_file_path_clone));
+    ASSERT_TRUE(fs::is_regular_file(test_file_path));
+    ASSERT_STREQ("blabla", Glib::file_get_contents(test_file_path_clone.string()).c_str());
+    ASSERT_FALSE(fs::clone_file(fs::path{UT::unitTestsDataDir} / fs::path{"test_clone_missing.txt"}, test_file_path_clone));
+
+    ASSERT_TRUE(fs::remove(test_file_path));
+    ASSERT_TRUE(fs::remove(test_file_path_clone));
+}
+
 TEST(FileSystemGroup, relative)
 {
 #ifdef _WIN32
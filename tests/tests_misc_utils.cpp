@@ -336,6 +336,13 @@ TEST(MiscUtilsGroup, str__diacritical_to_ascii)
     ASSERT_STREQ("li", str::diacritical_to_ascii("lì").c_str());
     ASSERT_STREQ("puo", str::diacritical_to_ascii("può").c_str());
     ASSERT_STREQ("piu", str::diacritical_to_ascii("più").c_str());
+    ASSERT_STREQ("Ze Ay", str::diacritical_to_ascii("Ẓe Ạỵ").c_str());
+    ASSERT_STREQ("", str::diacritical_to_ascii("").c_str());
+    // characters without ascii folding are kept, the characters offsets are unchanged
+    const Glib::ustring mixed{"€ çà 日本 ñ"};
+    const Glib::ustring folded = str::diacritical_to_ascii(mixed);
+    ASSERT_STREQ("€ ca 日本 n", folded.c_str());
+    ASSERT_EQ(mixed.size(), folded.size());
 }
 
 TEST(MiscUtilsGroup, vec_remove)
@@ -474,6 +481,78 @@ TEST(MiscUtilsGroup, parallel_for)
         }
 }
 
+TEST(MiscUtilsGroup, CtUtf8Cursor)
+{
+    CtUtf8Cursor cursor;
+    cursor.set_text("aèb€c");
+    // forward, backward and back from the text start
+    ASSERT_EQ(0, cursor.char_to_byte(0));
+    ASSERT_EQ(3, cursor.char_to_byte(2));
+    ASSERT_EQ(7, cursor.char_to_byte(4));
+    ASSERT_EQ(8, cursor.char_to_byte(5));
+    ASSERT_EQ(1, cursor.char_to_byte(1));
+    ASSERT_EQ(4, cursor.byte_to_char(7));
+    ASSERT_EQ(2, cursor.byte_to_char(3));
+    ASSERT_EQ(0, cursor.byte_to_char(0));
+    ASSERT_EQ(5, cursor.byte_to_char(8));
+    // replacement after the running position keeps it, before resets it
+    ASSERT_EQ(3, cursor.char_to_byte(2));
+    cursor.replace_bytes(4/*€*/, 7, "xyz");
+    ASSERT_STREQ("aèbxyzc", cursor.get_text().c_str());
+    ASSERT_EQ(8, cursor.char_to_byte(7));
+    cursor.replace_bytes(1/*è*/, 3, "€€");
+    ASSERT_STREQ("a€€bxyzc", cursor.get_text().c_str());
+    ASSERT_EQ(6, cursor.byte_to_char(10));
+    ASSERT_EQ(7, cursor.char_to_byte(3));
+}
+
+TEST(MiscUtilsGroup, CtLiteralFinder)
+{
+    const Glib::ustring text{"Foo food, FOO_x foo.\nÈfoo èFOO"};
+    int start{-1}, end{-1};
+    {
+        CtLiteralFinder finder{"foo", true/*matchCase*/, false/*wholeWord*/, false/*startWord*/};
+        ASSERT_TRUE(finder.find_forward(text, 0, start, end));
+        ASSERT_EQ(4, start);
+        ASSERT_EQ(7, end);
+        ASSERT_TRUE(finder.find_forward(text, 5, start, end));
+        ASSERT_EQ(16, start);
+        ASSERT_TRUE(finder.find_backward(text, 16, start, end));
+        ASSERT_EQ(4, start);
+        ASSERT_TRUE(finder.find_backward(text, static_cast<int>(text.bytes()), start, end));
+        ASSERT_EQ(23, start);
+        ASSERT_FALSE(finder.find_backward(text, 6, start, end));
+    }
+    {
+        CtLiteralFinder finder{"foo", false/*matchCase*/, true/*wholeWord*/, false/*startWord*/};
+        ASSERT_TRUE(finder.find_forward(text, 1, start, end));
+        ASSERT_EQ(16, start); // Foo food FOO_x skipped
+        ASSERT_FALSE(finder.find_forward(text, 17, start, end)); // Èfoo èFOO are words
+        ASSERT_TRUE(finder.find_backward(text, 3, start, end));
+        ASSERT_EQ(0, start);
+    }
+    {
+        CtLiteralFinder finder{"ÈfOO", false/*matchCase*/, false/*wholeWord*/, true/*startWord*/};
+        ASSERT_TRUE(finder.find_forward(text, 0, start, end));
+        ASSERT_EQ(21, start);
+        ASSERT_EQ(26, end);
+        ASSERT_TRUE(finder.find_forward(text, 22, start, end));
+        ASSERT_EQ(27, start);
+        ASSERT_EQ(32, end);
+    }
+    ASSERT_TRUE(CtLiteralFinder("o.\n", true, false, false).match(text));
+    ASSERT_FALSE(CtLiteralFinder("x", false, false, true).match(text));
+    ASSERT_FALSE(CtLiteralFinder("", false, false, false).match(text));
+    // the case forms are those of the caseless regex, by simple case folding
+    ASSERT_TRUE(CtLiteralFinder("kilo", false, false, false).match(Glib::ustring{"\u212Ailo"})); // KELVIN SIGN
+    ASSERT_TRUE(CtLiteralFinder("σοφος", false, false, false).match(Glib::ustring{"ΣΟΦΟΣ"}));
+    ASSERT_TRUE(CtLiteralFinder("ςσ", false, false, false).match(Glib::ustring{"σς"}));
+    ASSERT_TRUE(CtLiteralFinder("ß", false, false, false).match(Glib::ustring{"\u1E9E"}));
+    ASSERT_FALSE(CtLiteralFinder("i", false, false, false).match(Glib::ustring{"\u0130"}));
+    ASSERT_FALSE(CtLiteralFinder("\u0130", false, false, false).match(Glib::ustring{"Ii"}));
+    ASSERT_TRUE(CtLiteralFinder("x\u0130", false, false, false).match(Glib::ustring{"X\u0130"}));
+}
+
 TEST(MiscUtilsGroup, get_link_entry)
 {
     ASSERT_STREQ(CtConst::LINK_TYPE_WEBS.c_str(), CtMiscUtil::get_link_entry("webs https://example.com").type.c_str());
@@ -22,9 +22,12 @@
  */
 
 #include "ct_app.h"
+#include "ct_buffer_blob.h"
 #include "ct_misc_utils.h"
 #include "ct_storage_control.h"
+#include "ct_storage_xml.h"
 #include "tests_common.h"
+#include <sqlite3.h>
 
 class TestCtApp : public CtApp
 {
@@ -106,6 +109,12 @@ void TestCtApp::_run_test(const fs::path doc_filepath_from, const fs::path doc_f
     ASSERT_TRUE(pWin2->file_open(tmp_filepath, ""/*file*/, ""/*anchor*/, docEncrypt_to != CtDocEncrypt::True ? "" : UT::testPasswordBis));
     // check tree
     _assert_tree_data(pWin2, false/*after_mods*/);
+    {
+        const CtStorageStats stats = pWin2->get_ct_storage()->get_stats();
+        ASSERT_FALSE(stats.backend.empty());
+        ASSERT_TRUE(stats.nodesLoaded > 0u);
+        ASSERT_TRUE(stats.has_load_span("populate"));
+    }
 
     const CtStorageSyncPending* pCtStorageSyncPending = pWin2->get_ct_storage()->get_storage_sync_pending();
     {
@@ -160,11 +169,39 @@ void TestCtApp::_run_test(const fs::path doc_filepath_from, const fs::path doc_f
 
     // save
     ASSERT_TRUE(pWin2->file_save(false/*need_vacuum*/));
+    {
+        const CtStorageStats stats = pWin2->get_ct_storage()->get_stats();
+        ASSERT_TRUE(stats.has_save_span("write"));
+        ASSERT_TRUE(stats.has_save_span("nodes"));
+        ASSERT_TRUE(stats.nodesWritten > 0u);
+    }
+    // content index, if the sqlite library supports it
+    const gint64 node_id_e = pWin2->get_tree_store().get_node_from_node_name("e").get_node_id_data_holder();
+    const gint64 node_id_d = pWin2->get_tree_store().get_node_from_node_name("d").get_node_id();
+    const gint64 node_id_py = pWin2->get_tree_store().get_node_from_node_name("py").get_node_id();
+    std::unordered_set<gint64> node_ids;
+    const bool has_content_index = CtDocType::SQLite == doc_type and
+        pWin2->get_ct_storage()->get_nodes_may_contain("after_mods", true/*match_case*/, node_ids);
+    if (has_content_index) {
+        ASSERT_TRUE(node_ids.count(node_id_e));
+        ASSERT_FALSE(node_ids.count(node_id_d));
+        ASSERT_FALSE(node_ids.count(node_id_py));
+    }
 
     // close this window/tree
     pWin2->force_exit() = true;
     remove_window(*pWin2);
 
+    const bool test_stale_index_row = has_content_index and CtDocEncrypt::False == docEncrypt_to;
+    if (test_stale_index_row) {
+        // node "d" written without its index row, as by a version not aware of the index
+        sqlite3* pDb{nullptr};
+        ASSERT_EQ(SQLITE_OK, sqlite3_open(tmp_filepath.c_str(), &pDb));
+        const std::string sqlCmd = "UPDATE node SET ts_lastsave=ts_lastsave+1 WHERE node_id=" + std::to_string(node_id_d);
+        ASSERT_EQ(SQLITE_OK, sqlite3_exec(pDb, sqlCmd.c_str(), nullptr, nullptr, nullptr));
+        ASSERT_EQ(SQLITE_OK, sqlite3_close(pDb));
+    }
+
     // new empty window/tree
     CtMainWin* pWin3 = _create_window(true/*start_hidden*/);
     // tree empty
@@ -173,6 +210,14 @@ void TestCtApp::_run_test(const fs::path doc_filepath_from, const fs::path doc_f
     ASSERT_TRUE(pWin3->file_open(tmp_filepath, ""/*file*/, ""/*anchor*/, docEncrypt_to != CtDocEncrypt::True ? "" : UT::testPasswordBis));
     // check tree
     _assert_tree_data(pWin3, true/*after_mods*/);
+    if (test_stale_index_row) {
+        // a stale index row cannot rule its node out
+        node_ids.clear();
+        ASSERT_TRUE(pWin3->get_ct_storage()->get_nodes_may_contain("after_mods", true/*match_case*/, node_ids));
+        ASSERT_TRUE(node_ids.count(node_id_e));
+        ASSERT_TRUE(node_ids.count(node_id_d));
+        ASSERT_FALSE(node_ids.count(node_id_py));
+    }
 
     // close this window/tree
     pWin3->force_exit() = true;
@@ -710,3 +755,189 @@ INSTANTIATE_TEST_CASE_P(
                 std::make_tuple(UT::testCtzDocPath, UT::testCtxDocPath, false/*test_save*/),
                 std::make_tuple(UT::testCtzDocPath, UT::testMultiFilePath, false/*test_save*/))
 );
+
+class TestCtAppAsyncSave : public CtApp
+{
+public:
+    TestCtAppAsyncSave()
+     : CtApp{"_test_async_save"}
+    {
+        _no_gui = true;
+    }
+
+private:
+    void on_activate() final;
+
+    void _append_to_node_e(CtMainWin* pWin, const Glib::ustring& text);
+};
+
+void TestCtAppAsyncSave::_append_to_node_e(CtMainWin* pWin, const Glib::ustring& text)
+{
+    CtTreeIter ctTreeIter = pWin->get_tree_store().get_node_from_node_name("e");
+    auto pTextBuffer = ctTreeIter.get_node_text_buffer();
+    pTextBuffer->insert(pTextBuffer->end(), text);
+    pWin->update_window_save_needed(CtSaveNeededUpdType::nbuf, false/*new_machine_state*/, &ctTreeIter);
+}
+
+void TestCtAppAsyncSave::on_activate()
+{
+    _on_startup();
+
+    CtMainWin* pWin = _create_window(true/*start_hidden*/);
+    ASSERT_TRUE(pWin->file_open(UT::testCtdDocPath, ""/*node_to_focus*/, ""/*anchor_to_focus*/));
+    const fs::path tmp_dirpath = pWin->get_ct_tmp()->getHiddenDirPath("UT_async_save");
+    const fs::path tmp_ctd_filepath = tmp_dirpath / "async_save.ctd";
+    const fs::path tmp_ctz_filepath = tmp_dirpath / "async_save.ctz";
+    pWin->file_save_as(tmp_ctd_filepath.string(), CtDocType::XML, ""/*password*/);
+    pWin->file_save_as(tmp_ctz_filepath.string(), CtDocType::XML, UT::testPasswordBis);
+    pWin->force_exit() = true;
+    remove_window(*pWin);
+
+    // commit: the snapshot written on the worker thread replaces the document
+    CtMainWin* pWin2 = _create_window(true/*start_hidden*/);
+    ASSERT_TRUE(pWin2->file_open(tmp_ctd_filepath, ""/*node_to_focus*/, ""/*anchor_to_focus*/));
+    pWin2->get_ct_config()->backupCopy = true;
+    pWin2->get_ct_config()->backupNum = 3;
+    CtStorageControl* pStorage2 = pWin2->get_ct_storage();
+    _append_to_node_e(pWin2, "after_async");
+    Glib::ustring error;
+    ASSERT_TRUE(pStorage2->save_async(error));
+    ASSERT_TRUE(pStorage2->is_saving_async());
+    // the pending changes are with the snapshot
+    ASSERT_TRUE(pStorage2->get_storage_sync_pending()->nodes_to_write_dict.empty());
+    pStorage2->save_async_wait();
+    ASSERT_FALSE(pStorage2->is_saving_async());
+    ASSERT_TRUE(pStorage2->get_storage_sync_pending()->nodes_to_write_dict.empty());
+    ASSERT_TRUE(pStorage2->get_stats().has_save_span("snapshot"));
+    ASSERT_TRUE(pStorage2->get_stats().has_save_span("write"));
+    pWin2->force_exit() = true;
+    remove_window(*pWin2);
+
+    CtMainWin* pWin3 = _create_window(true/*start_hidden*/);
+    ASSERT_TRUE(pWin3->file_open(tmp_ctd_filepath, ""/*node_to_focus*/, ""/*anchor_to_focus*/));
+    {
+        CtTreeIter ctTreeIter = pWin3->get_tree_store().get_node_from_node_name("e");
+        ASSERT_TRUE(str::endswith(ctTreeIter.get_node_text_buffer()->get_text().raw(), "after_async"));
+    }
+    pWin3->force_exit() = true;
+    remove_window(*pWin3);
+
+    // rollback: the writing fails, the main backup is put back and the pending changes are merged back
+    CtMainWin* pWin4 = _create_window(true/*start_hidden*/);
+    ASSERT_TRUE(pWin4->file_open(tmp_ctz_filepath, ""/*node_to_focus*/, ""/*anchor_to_focus*/, UT::testPasswordBis));
+    pWin4->get_ct_config()->backupCopy = true;
+    pWin4->get_ct_config()->backupNum = 3;
+    CtStorageControl* pStorage4 = pWin4->get_ct_storage();
+    _append_to_node_e(pWin4, "after_rollback");
+    const gint64 node_id_e = pWin4->get_tree_store().get_node_from_node_name("e").get_node_id_data_holder();
+    const std::string archive_before = Glib::file_get_contents(tmp_ctz_filepath.string());
+    // the plaintext document is written in the hidden directory, without it the writing fails
+    ASSERT_TRUE(fs::remove_all(pWin4->get_ct_tmp()->getHiddenDirPath(tmp_ctz_filepath)) > 0);
+    bool save_done_ok{true};
+    pStorage4->signal_save_done.clear(); // no error dialog
+    pStorage4->signal_save_done.connect([&save_done_ok](const bool ok, Glib::ustring){ save_done_ok = ok; });
+    error.clear();
+    ASSERT_TRUE(pStorage4->save_async(error));
+    ASSERT_FALSE(fs::exists(tmp_ctz_filepath)); // moved to the main backup
+    pStorage4->save_async_wait();
+    ASSERT_FALSE(save_done_ok);
+    ASSERT_TRUE(fs::exists(tmp_ctz_filepath));
+    ASSERT_EQ(archive_before, Glib::file_get_contents(tmp_ctz_filepath.string()));
+    ASSERT_TRUE(pStorage4->get_storage_sync_pending()->nodes_to_write_dict.at(node_id_e).buff);
+    pWin4->force_exit() = true;
+    remove_window(*pWin4);
+}
+
+TEST(ReadWriteGroup, AsyncSaveCommitRollback)
+{
+    const std::vector<std::string> vec_args{"cherrytree"};
+    gchar** pp_args = CtStrUtil::vector_to_array(vec_args);
+    TestCtAppAsyncSave testCtApp{};
+    testCtApp.run(vec_args.size(), pp_args);
+    g_strfreev(pp_args);
+}
+
+class TestCtAppBufferBlob : public CtApp
+{
+public:
+    TestCtAppBufferBlob()
+     : CtApp{"_test_buffer_blob"}
+    {
+        _no_gui = true;
+    }
+
+private:
+    void on_activate() final;
+};
+
+void TestCtAppBufferBlob::on_activate()
+{
+    _on_startup();
+
+    CtMainWin* pWin = _create_window(true/*start_hidden*/);
+    ASSERT_TRUE(pWin->file_open(UT::testCtdDocPath, ""/*node_to_focus*/, ""/*anchor_to_focus*/));
+    // links tagged runs and the anchored widgets of every type
+    CtTreeIter ctTreeIter = pWin->get_tree_store().get_node_from_node_name("e");
+    ASSERT_TRUE(ctTreeIter);
+    Glib::RefPtr<Gsv::Buffer> rTextBuffer = ctTreeIter.get_node_text_buffer();
+    const std::list<CtAnchoredWidget*> anchoredWidgets = ctTreeIter.get_anchored_widgets();
+    ASSERT_EQ(7, anchoredWidgets.size());
+    CtBufferBlob bufferBlob;
+    bufferBlob.encode(pWin->get_ct_config(), rTextBuffer, anchoredWidgets);
+    ASSERT_EQ(7, bufferBlob.get_num_widgets());
+    ASSERT_TRUE(bufferBlob.get_num_spans() > 5); // the untagged runs between the 5 links
+
+    Glib::RefPtr<Gsv::Buffer> rDecodedBuffer = pWin->get_new_text_buffer();
+    std::list<CtAnchoredWidget*> decodedWidgets;
+    bufferBlob.decode(pWin, rDecodedBuffer, decodedWidgets);
+    ASSERT_STREQ(rTextBuffer->get_text().c_str(), rDecodedBuffer->get_text().c_str());
+    ASSERT_EQ(anchoredWidgets.size(), decodedWidgets.size());
+    auto itDecoded = decodedWidgets.begin();
+    for (CtAnchoredWidget* pAnchWidget : anchoredWidgets) {
+        ASSERT_EQ(pAnchWidget->get_type(), (*itDecoded)->get_type());
+        ASSERT_EQ(pAnchWidget->getOffset(), (*itDecoded)->getOffset());
+        ASSERT_STREQ(pAnchWidget->getJustification().c_str(), (*itDecoded)->getJustification().c_str());
+        ++itDecoded;
+    }
+    // the decoded buffer encodes to the same spans, tags and widgets states
+    CtBufferBlob decodedBufferBlob;
+    decodedBufferBlob.encode(pWin->get_ct_config(), rDecodedBuffer, decodedWidgets);
+    ASSERT_TRUE(bufferBlob == decodedBufferBlob);
+    // while a different tag does not
+    rDecodedBuffer->apply_tag_by_name(pWin->get_text_tag_name_exist_or_create(CtConst::TAG_WEIGHT, CtConst::TAG_PROP_VAL_HEAVY),
+                                      rDecodedBuffer->begin(), rDecodedBuffer->get_iter_at_offset(3));
+    decodedBufferBlob.encode(pWin->get_ct_config(), rDecodedBuffer, decodedWidgets);
+    ASSERT_TRUE(bufferBlob != decodedBufferBlob);
+    ASSERT_EQ(bufferBlob.get_text(), decodedBufferBlob.get_text());
+
+    for (CtAnchoredWidget* pAnchWidget : decodedWidgets) {
+        delete pAnchWidget;
+    }
+    pWin->force_exit() = true;
+    remove_window(*pWin);
+}
+
+TEST(ReadWriteGroup, BufferBlobRoundTrip)
+{
+    const std::vector<std::string> vec_args{"cherrytree"};
+    gchar** pp_args = CtStrUtil::vector_to_array(vec_args);
+    TestCtAppBufferBlob testCtApp{};
+    testCtApp.run(vec_args.size(), pp_args);
+    g_strfreev(pp_args);
+}
+
+TEST(ReadWriteGroup, XmlStructureCheck)
+{
+    CtStorageXml storageXml{nullptr};
+    Glib::ustring error;
+    ASSERT_TRUE(storageXml.structure_check_from_memory(Glib::file_get_contents(UT::testCtdDocPath), error));
+    ASSERT_TRUE(storageXml.structure_check(UT::testCtdDocPath, error));
+
+    error.clear();
+    ASSERT_FALSE(storageXml.structure_check_from_memory("<?xml version=\"1.0\"?><notcherrytree/>", error));
+    ASSERT_STREQ("document contains the wrong node root", error.c_str());
+
+    error.clear();
+    ASSERT_FALSE(storageXml.structure_check_from_memory("<?xml version=\"1.0\"?><cherrytree><node>", error));
+    ASSERT_STREQ("xml parse fail", error.c_str());
+}
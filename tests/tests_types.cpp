@@ -23,8 +23,11 @@
 
 #include "ct_types.h"
 #include "ct_filesystem.h"
+#include "ct_trigram_index.h"
+#include "ct_storage_stats.h"
 #include "tests_common.h"
 #include <thread>
+#include <future>
 
 TEST(TestTypesGroup, ctMaxSizedList)
 {
@@ -127,6 +130,53 @@ TEST(TestTypesGroup, ThreadSafeDEQueue_MaxElements)
     ASSERT_EQ(3, threadSafeDEQueue.size());
 }
 
+TEST(TestTypesGroup, ThreadSafeDEQueue_Coalesce)
+{
+    // pairs of document and state, only the newest state of a document is kept
+    ThreadSafeDEQueue<std::pair<int,int>,500> threadSafeDEQueue;
+    auto f_same_doc = [](const std::pair<int,int>& newer, std::pair<int,int>& queued){ return newer.first == queued.first; };
+    ASSERT_TRUE(threadSafeDEQueue.push_back_coalesce(std::make_pair(1, 1), f_same_doc).empty());
+    ASSERT_TRUE(threadSafeDEQueue.push_back_coalesce(std::make_pair(2, 1), f_same_doc).empty());
+    const std::list<std::pair<int,int>> superseded = threadSafeDEQueue.push_back_coalesce(std::make_pair(1, 2), f_same_doc);
+    ASSERT_EQ(1, superseded.size());
+    ASSERT_EQ(std::make_pair(1, 1), superseded.front());
+    ASSERT_EQ(2, threadSafeDEQueue.size());
+    ASSERT_EQ(std::make_pair(2, 1), threadSafeDEQueue.pop_front());
+    ASSERT_EQ(std::make_pair(1, 2), threadSafeDEQueue.pop_front());
+}
+
+TEST(TestTypesGroup, ThreadSafeDEQueue_CoalesceWaitsForRoom)
+{
+    ThreadSafeDEQueue<int,3> threadSafeDEQueue;
+    auto f_never = [](const int, int&){ return false; };
+    for (int i = 0; i < 3; ++i) {
+        threadSafeDEQueue.push_back_coalesce(i, f_never);
+    }
+    // f_superseded runs under the queue lock, that the pusher then only releases to wait for room
+    std::promise<void> pusherLocked;
+    bool pusherLockedSet{false};
+    std::thread pusher([&](){
+        // the queue is full, this waits for the pop rather than dropping
+        threadSafeDEQueue.push_back_coalesce(3, [&](const int, int&){
+            if (not pusherLockedSet) {
+                pusherLockedSet = true;
+                pusherLocked.set_value();
+            }
+            return false;
+        });
+    });
+    pusherLocked.get_future().wait();
+    const size_t sizeWhileWaiting = threadSafeDEQueue.size();
+    const int popped = threadSafeDEQueue.pop_front();
+    pusher.join();
+    ASSERT_EQ(3, sizeWhileWaiting);
+    ASSERT_EQ(0, popped);
+    ASSERT_EQ(3, threadSafeDEQueue.size());
+    for (int i = 1; i < 4; ++i) {
+        ASSERT_EQ(i, threadSafeDEQueue.pop_front());
+    }
+}
+
 TEST(TestTypesGroup, ctScalableTag)
 {
     {
@@ -180,4 +230,96 @@ TEST(TestTypesGroup, CtStockIcon)
     ASSERT_STREQ(CtStockIcon::at(14u), "ct_home");
 
     ASSERT_EQ(CtStockIcon::size(), CtConst::_NODE_CUSTOM_ICONS.size());
-}
\ No newline at end of file
+}
+
+TEST(TestTypesGroup, CtTrigramIndex)
+{
+    CtTrigramIndex trigramIndex;
+    trigramIndex.add(1, "Hello World");
+    trigramIndex.add(2, "Ciao Mondo");
+    trigramIndex.add(3, "Привет мир");
+    ASSERT_EQ(3u, trigramIndex.size());
+    ASSERT_TRUE(trigramIndex.has(2));
+    ASSERT_FALSE(trigramIndex.has(4));
+
+    std::unordered_set<gint64> ids;
+    // too short to be answered
+    ASSERT_FALSE(trigramIndex.query("lo", ids));
+    ASSERT_TRUE(ids.empty());
+    // case folded, also across non ascii characters
+    ASSERT_TRUE(trigramIndex.query("WORLD", ids));
+    ASSERT_EQ(std::unordered_set<gint64>({1}), ids);
+    ids.clear();
+    ASSERT_TRUE(trigramIndex.query("ПРИВЕТ", ids));
+    ASSERT_EQ(std::unordered_set<gint64>({3}), ids);
+    ids.clear();
+    ASSERT_TRUE(trigramIndex.query("o Mo", ids));
+    ASSERT_EQ(std::unordered_set<gint64>({2}), ids);
+    ids.clear();
+    ASSERT_TRUE(trigramIndex.query("missing", ids));
+    ASSERT_TRUE(ids.empty());
+
+    // update and removal
+    trigramIndex.add(2, "Hello Mondo");
+    ASSERT_TRUE(trigramIndex.query("hello", ids));
+    ASSERT_EQ(std::unordered_set<gint64>({1, 2}), ids);
+    ids.clear();
+    trigramIndex.remove(1);
+    ASSERT_FALSE(trigramIndex.has(1));
+    ASSERT_TRUE(trigramIndex.query("hello", ids));
+    ASSERT_EQ(std::unordered_set<gint64>({2}), ids);
+    ids.clear();
+    trigramIndex.clear();
+    ASSERT_EQ(0u, trigramIndex.size());
+    ASSERT_TRUE(trigramIndex.query("hello", ids));
+    ASSERT_TRUE(ids.empty());
+}
+
+TEST(TestTypesGroup, CtNodeNamesIndex)
+{
+    CtNodeNamesIndex nodeNamesIndex;
+    nodeNamesIndex.set(1, "Projects", "Projects");
+    nodeNamesIndex.set(2, "Cherrytree", "Projects / Cherrytree");
+    nodeNamesIndex.set(3, "Tree Notes", "Projects / Cherrytree / Tree Notes");
+    nodeNamesIndex.set(4, "Привет", "Привет");
+    ASSERT_EQ(4u, nodeNamesIndex.size());
+
+    // name prefix, then name substring, then path substring
+    ASSERT_EQ(std::vector<gint64>({3, 2}), nodeNamesIndex.find("TREE", 10));
+    ASSERT_EQ(std::vector<gint64>({1, 2, 3}), nodeNamesIndex.find("proj", 10));
+    ASSERT_EQ(std::vector<gint64>({1, 2}), nodeNamesIndex.find("proj", 2));
+    // short filters are scanned, without fuzzy matches
+    ASSERT_EQ(std::vector<gint64>({4}), nodeNamesIndex.find("пр", 10));
+    ASSERT_EQ(std::vector<gint64>{}, nodeNamesIndex.find("zz", 10));
+    // a typo still finds the nodes through the shared trigrams
+    ASSERT_EQ(std::vector<gint64>({2, 3}), nodeNamesIndex.find("cherrytrre", 10));
+
+    // rename and removal
+    nodeNamesIndex.set(2, "Cherry", "Projects / Cherry");
+    nodeNamesIndex.set(3, "Tree Notes", "Projects / Cherry / Tree Notes");
+    ASSERT_EQ(std::vector<gint64>({3}), nodeNamesIndex.find("tree", 10));
+    nodeNamesIndex.retain({1, 2, 4});
+    ASSERT_FALSE(nodeNamesIndex.has(3));
+    ASSERT_EQ(std::vector<gint64>{}, nodeNamesIndex.find("notes", 10));
+    nodeNamesIndex.remove(4);
+    ASSERT_EQ(2u, nodeNamesIndex.size());
+}
+
+TEST(TestTypesGroup, CtStorageStatsRecorder_LateSpans)
+{
+    CtStorageStatsRecorder statsRecorder;
+    statsRecorder.begin(CtStorageStatsRecorder::Op::Save, "xml");
+    const guint64 saveSeq = statsRecorder.get_save_seq();
+    statsRecorder.add_span(CtStorageStatsRecorder::Op::Save, "write", 1.0);
+    statsRecorder.add_span(CtStorageStatsRecorder::Op::Save, "archive", 1.0, saveSeq);
+    ASSERT_TRUE(statsRecorder.get().has_save_span("archive"));
+
+    // a span of the previous save, recorded once the next one started, is dropped
+    statsRecorder.begin(CtStorageStatsRecorder::Op::Save, "xml");
+    ASSERT_NE(saveSeq, statsRecorder.get_save_seq());
+    statsRecorder.add_span(CtStorageStatsRecorder::Op::Save, "backup_rotate", 1.0, saveSeq);
+    ASSERT_FALSE(statsRecorder.get().has_save_span("backup_rotate"));
+    statsRecorder.add_span(CtStorageStatsRecorder::Op::Save, "backup_rotate", 1.0, statsRecorder.get_save_seq());
+    ASSERT_TRUE(statsRecorder.get().has_save_span("backup_rotate"));
+    ASSERT_FALSE(statsRecorder.get().has_save_span("write"));
+}